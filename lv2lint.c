@@ -20,11 +20,9 @@
 #include <ctype.h>
 #include <unistd.h>
 #include <string.h>
+#include <math.h>
 #include <assert.h>
-#if defined(HAS_FNMATCH)
-#	include <fnmatch.h>
-#endif
-
+#include <getopt.h>
 #include <lv2lint.h>
 
 #include <lv2/patch/patch.h>
@@ -47,16 +45,14 @@
 #include <lv2/ui/ui.h>
 #include <lv2/units/units.h>
 
-#ifdef ENABLE_ELF_TESTS
-#	include <fcntl.h>
-#	include <libelf.h>
-#	include <gelf.h>
-#endif
-
 #define MAPPER_API static inline
 #define MAPPER_IMPLEMENTATION
 #include <mapper.lv2/mapper.h>
 
+#ifdef ENABLE_ELF_TESTS
+#	include <elf.h>
+#endif
+
 const char *colors [2][ANSI_COLOR_MAX] = {
 	{
 		[ANSI_COLOR_BOLD]    = "",
@@ -731,6 +727,8 @@ _usage(char **argv)
 		"--------------------------------------------------------------------\n"
 		"USAGE\n"
 		"   %s [OPTIONS] {PLUGIN_URI}*\n"
+		"   %s [OPTIONS] -A {PLUGIN_URI_PATTERN}*\n"
+		"   %s [OPTIONS] --server SOCKET_PATH\n"
 		"\n"
 		"OPTIONS\n"
 		"   [-v]                         print version information\n"
@@ -743,11 +741,20 @@ _usage(char **argv)
 		                                 " (can be used multiple times)\n"
 		"   [-t] TEST_PATTERN            test name pattern (shell wildcards) to whitelist"
 		                                 " (can be used multiple times)\n"
+		"   [-T] TEST_PATTERN            test name pattern (shell wildcards) to run exclusively"
+		                                 " (can be used multiple times)\n"
+		"   [-X] TEST_PATTERN            test name pattern (shell wildcards) to not run"
+		                                 " (can be used multiple times)\n"
+		"   [-j] JOBS                    number of plugins to test in parallel worker processes\n"
+		"   [-w] TIMEOUT                 test each plugin in a sandboxed process, killed after"
+		                                 " TIMEOUT seconds (0: no timeout)\n"
 #ifdef ENABLE_ELF_TESTS
 		"   [-s] SYMBOL_PATTERN          symbol pattern (shell wildcards) to whitelist"
 		                                 " (can be used multiple times)\n"
 		"   [-l] LIBRARY_PATTERN         library pattern (shell wildcards) to whitelist"
 		                                 " (can be used multiple times)\n"
+		"   [-r] SYMBOL_PATTERN          symbol pattern (shell wildcards) to treat as not"
+		                                 " real-time safe (can be used multiple times)\n"
 #endif
 #ifdef ENABLE_ONLINE_TESTS
 		"   [-o]                         run online test items\n"
@@ -757,8 +764,25 @@ _usage(char **argv)
 
 		"   [-M] (no)pack                skip some tests for distribution packagers\n"
 		"   [-S] (no)warn|note|pass|all  show warnings, notes, passes or all\n"
-		"   [-E] (no)warn|note|all       treat warnings, notes or all as errors\n\n"
-		, argv[0]);
+		"   [-E] (no)warn|note|all       treat warnings, notes or all as errors\n"
+		"   [-c]                         cache results of unchanged plugins\n"
+		"   [-F]                         fast start, only load bundles of given plugins\n"
+		"   [-A]                         test all plugins (matching URI patterns, shell wildcards)\n"
+		"   [--shard] INDEX/COUNT        only test the INDEX-th of COUNT stable URI hash shards\n"
+		"   [--server] SOCKET_PATH       keep plugin world loaded and serve lint requests on UNIX socket\n"
+		"   [--client] SOCKET_PATH       send lint request to server on UNIX socket\n"
+		"   [--timings]                  print per-plugin and aggregate phase and test timings\n"
+		"   [--trace] FILE               write Chrome trace-event JSON of plugins, tests and phases\n"
+		"   [--format] text|jsonl|junit|sarif  report format\n"
+		"   [--fail-fast]                stop testing a plugin at its first failure\n"
+#if defined(HAS_INOTIFY)
+		"   [--watch]                    re-test plugins when their include directory changes\n"
+#endif
+#ifdef ENABLE_ELF_TESTS
+		"   [--isa-baseline] LEVEL       x86-64 ISA level of target machines (x86-64, x86-64-v2, -v3, -v4)\n"
+#endif
+		"\n"
+		, argv[0], argv[0], argv[0]);
 }
 
 #ifdef ENABLE_ONLINE_TESTS
@@ -787,7 +811,9 @@ test_url(app_t *app, const char *url)
 	curl_easy_setopt(app->curl, CURLOPT_CONNECTTIMEOUT, 10L); // secs
 	curl_easy_setopt(app->curl, CURLOPT_TIMEOUT, 20L); //secs
 
+	const uint64_t t0 = lv2lint_now();
 	const CURLcode resp = curl_easy_perform(app->curl);
+	lv2lint_timing(app, TIMING_PHASE, "Online Check", t0);
 
 	long http_code;
 	curl_easy_getinfo(app->curl, CURLINFO_RESPONSE_CODE, &http_code);
@@ -843,60 +869,12 @@ _white_free(white_t *white)
 	return NULL;
 }
 
-static bool
-_pattern_match(const char *pattern, const char *str)
-{
-	if(pattern == NULL)
-	{
-		return true;
-	}
-
-#if defined(HAS_FNMATCH)
-	if(fnmatch(pattern, str, FNM_CASEFOLD) == 0)
-#else
-	if(strcasecmp(pattern, str) == 0)
-#endif
-	{
-		return true;
-	}
-
-	return false;
-}
-
-static bool
-_white_match(const white_t *white, const char *uri, const char *str)
-{
-	for( ; white; white = white->next)
-	{
-		if(_pattern_match(white->uri, uri) && _pattern_match(white->pattern, str))
-		{
-			return true;
-		}
-	}
-
-	return false;
-}
-
 #ifdef ENABLE_ELF_TESTS
 static void
-_append_to(char **dst, const char *src)
+_append_to(strbuf_t *dst, const char *src)
 {
-	static const char *prefix = "\n                * ";
-
-	if(*dst)
-	{
-		const size_t sz = strlen(*dst) + strlen(prefix) + strlen(src) + 1;
-		*dst = realloc(*dst, sz);
-		strcat(*dst, prefix);
-		strcat(*dst, src);
-	}
-	else
-	{
-		const size_t sz = strlen(src) + strlen(prefix) + 1;
-		*dst = malloc(sz);
-		strcpy(*dst, prefix);
-		strcat(*dst, src);
-	}
+	lv2lint_strbuf_puts(dst, "\n                * ");
+	lv2lint_strbuf_puts(dst, src);
 }
 
 bool
@@ -935,236 +913,371 @@ test_visibility(app_t *app, const char *path, const char *uri,
 		"rust_eh_personality"
 	};
 	const unsigned n_whitelist = sizeof(whitelist) / sizeof(const char *);
+	strbuf_t list = { .buf = NULL };
 	bool desc = false;
 	unsigned invalid = 0;
 
-	const int fd = open(path, O_RDONLY);
-	if(fd != -1)
+	const elf_facts_t *facts = lv2lint_elf_facts(app, path);
+	if(facts)
 	{
-		elf_version(EV_CURRENT);
-
-		Elf *elf = elf_begin(fd, ELF_C_READ, NULL);
-		if(elf)
+		// iterate over exported symbol names
+		for(unsigned i = 0; i < facts->n_exports; i++)
 		{
-			for(Elf_Scn *scn = elf_nextscn(elf, NULL);
-				scn;
-				scn = elf_nextscn(elf, scn))
+			const char *name = facts->exports[i];
+
+			if(!strcmp(name, description))
+			{
+				desc = true;
+			}
+			else
 			{
-				GElf_Shdr shdr;
-				memset(&shdr, 0x0, sizeof(GElf_Shdr));
-				gelf_getshdr(scn, &shdr);
+				bool whitelist_match = false;
 
-				if( (shdr.sh_type == SHT_SYMTAB) || (shdr.sh_type == SHT_DYNSYM) )
+				for(unsigned j = 0; j < n_whitelist; j++)
 				{
-					// found a symbol table
-					Elf_Data *data = elf_getdata(scn, NULL);
-					const unsigned count = shdr.sh_size / shdr.sh_entsize;
-
-					// iterate over symbol names
-					for(unsigned i = 0; i < count; i++)
+					if(!strcmp(name, whitelist[j]))
 					{
-						GElf_Sym sym;
-						memset(&sym, 0x0, sizeof(GElf_Sym));
-						gelf_getsym(data, i, &sym);
-
-						const bool is_global = GELF_ST_BIND(sym.st_info) == STB_GLOBAL;
-						if(sym.st_value && is_global)
-						{
-							const char *name = elf_strptr(elf, shdr.sh_link, sym.st_name);
-
-							if(!strcmp(name, description))
-							{
-								desc = true;
-							}
-							else
-							{
-								bool whitelist_match = false;
-
-								for(unsigned j = 0; j < n_whitelist; j++)
-								{
-									if(!strcmp(name, whitelist[j]))
-									{
-										whitelist_match = true;
-										break;
-									}
-								}
-
-								if(!whitelist_match)
-								{
-									if(_white_match(app->whitelist_symbols, uri, name))
-									{
-										whitelist_match = true;
-									}
-								}
+						whitelist_match = true;
+						break;
+					}
+				}
 
-								if(!whitelist_match)
-								{
-									if(invalid <= 10)
-									{
-										_append_to(symbols, (invalid == 10)
-											? "... there is more, but the rest is being truncated"
-											: name);
-									}
-									invalid++;
-								}
-							}
-						}
+				if(!whitelist_match)
+				{
+					if(lv2lint_matcher_match(&app->match_symbols, uri, name))
+					{
+						whitelist_match = true;
 					}
+				}
 
-					break;
+				if(!whitelist_match)
+				{
+					if(invalid <= 10)
+					{
+						_append_to(&list, (invalid == 10)
+							? "... there is more, but the rest is being truncated"
+							: name);
+					}
+					invalid++;
 				}
 			}
-			elf_end(elf);
 		}
-		close(fd);
 	}
 
+	*symbols = lv2lint_arena_strdup(app, list.buf);
+	lv2lint_strbuf_free(&list);
+
 	return !(!desc || invalid);
 }
 
 bool
-check_for_symbol(app_t *app __attribute__((unused)), const char *path,
-	const char *description)
+check_for_symbol(app_t *app, const char *path, const char *description)
 {
-	bool desc = false;
+	const elf_facts_t *facts = lv2lint_elf_facts(app, path);
 
-	const int fd = open(path, O_RDONLY);
-	if(fd != -1)
-	{
-		elf_version(EV_CURRENT);
+	return facts && lv2lint_elf_has_symbol(facts, description);
+}
+
+bool
+test_shared_libraries(app_t *app, const char *path, const char *uri,
+	const char *const *whitelist, unsigned n_whitelist,
+	const char *const *blacklist, unsigned n_blacklist,
+	char **libraries)
+{
+	strbuf_t list = { .buf = NULL };
+	unsigned invalid = 0;
 
-		Elf *elf = elf_begin(fd, ELF_C_READ, NULL);
-		if(elf)
+	const elf_facts_t *facts = lv2lint_elf_facts(app, path);
+	if(facts)
+	{
+		// iterate over linked shared library names
+		for(unsigned i = 0; i < facts->n_needed; i++)
 		{
-			for(Elf_Scn *scn = elf_nextscn(elf, NULL);
-				scn;
-				scn = elf_nextscn(elf, scn))
-			{
-				GElf_Shdr shdr;
-				memset(&shdr, 0x0, sizeof(GElf_Shdr));
-				gelf_getshdr(scn, &shdr);
+			const char *name = facts->needed[i];
 
-				if( (shdr.sh_type == SHT_SYMTAB) || (shdr.sh_type == SHT_DYNSYM) )
+			bool whitelist_match = false;
+			bool blacklist_match = false;
+
+			for(unsigned j = 0; j < n_whitelist; j++)
+			{
+				if(!strncmp(name, whitelist[j], strlen(whitelist[j])))
 				{
-					// found a symbol table
-					Elf_Data *data = elf_getdata(scn, NULL);
-					const unsigned count = shdr.sh_size / shdr.sh_entsize;
+					whitelist_match = true;
+					break;
+				}
+			}
 
-					// iterate over symbol names
-					for(unsigned i = 0; i < count; i++)
-					{
-						GElf_Sym sym;
-						memset(&sym, 0x0, sizeof(GElf_Sym));
-						gelf_getsym(data, i, &sym);
+			if(lv2lint_matcher_match(&app->match_libs, uri, name))
+			{
+				whitelist_match = true;
+			}
 
-						const char *name = elf_strptr(elf, shdr.sh_link, sym.st_name);
-						if(!strcmp(name, description))
-						{
-							desc = true;
-							break;
-						}
-					}
+			for(unsigned j = 0; j < n_blacklist; j++)
+			{
+				if(!strncmp(name, blacklist[j], strlen(blacklist[j])))
+				{
+					blacklist_match = true;
+					break;
 				}
 			}
-			elf_end(elf);
+
+			if(n_whitelist && !whitelist_match)
+			{
+				_append_to(&list, name);
+				invalid++;
+			}
+			if(n_blacklist && blacklist_match && !whitelist_match)
+			{
+				_append_to(&list, name);
+				invalid++;
+			}
 		}
-		close(fd);
 	}
 
-	return desc;
+	*libraries = lv2lint_arena_strdup(app, list.buf);
+	lv2lint_strbuf_free(&list);
+
+	return !invalid;
+}
+
+typedef enum _rt_category_t {
+	RT_ALLOCATION,
+	RT_LOCKING,
+	RT_BLOCKING_IO,
+	RT_SLEEPING,
+	RT_SYSCALL,
+	RT_CUSTOM,
+
+	RT_CATEGORY_MAX
+} rt_category_t;
+
+typedef struct _rt_symbol_t {
+	const char *name;
+	rt_category_t category;
+} rt_symbol_t;
+
+static const char *rt_categories [RT_CATEGORY_MAX] = {
+	[RT_ALLOCATION]  = "allocation",
+	[RT_LOCKING]     = "locking",
+	[RT_BLOCKING_IO] = "blocking I/O",
+	[RT_SLEEPING]    = "sleeping",
+	[RT_SYSCALL]     = "syscall",
+	[RT_CUSTOM]      = "custom"
+};
+
+// must be kept sorted by name for bsearch
+static const rt_symbol_t rt_symbols [] = {
+	{"_ZdaPv",                  RT_ALLOCATION}, // operator delete[]
+	{"_ZdaPvm",                 RT_ALLOCATION},
+	{"_ZdlPv",                  RT_ALLOCATION}, // operator delete
+	{"_ZdlPvm",                 RT_ALLOCATION},
+	{"_Znaj",                   RT_ALLOCATION}, // operator new[], 32-bit
+	{"_Znam",                   RT_ALLOCATION}, // operator new[]
+	{"_ZnamRKSt9nothrow_t",     RT_ALLOCATION},
+	{"_Znwj",                   RT_ALLOCATION}, // operator new, 32-bit
+	{"_Znwm",                   RT_ALLOCATION}, // operator new
+	{"_ZnwmRKSt9nothrow_t",     RT_ALLOCATION},
+	{"__cxa_allocate_exception", RT_ALLOCATION}, // throw
+	{"aligned_alloc",           RT_ALLOCATION},
+	{"calloc",                  RT_ALLOCATION},
+	{"clock_nanosleep",         RT_SLEEPING},
+	{"close",                   RT_BLOCKING_IO},
+	{"dlclose",                 RT_SYSCALL},
+	{"dlopen",                  RT_SYSCALL},
+	{"epoll_wait",              RT_SLEEPING},
+	{"execv",                   RT_SYSCALL},
+	{"execve",                  RT_SYSCALL},
+	{"execvp",                  RT_SYSCALL},
+	{"fclose",                  RT_BLOCKING_IO},
+	{"fflush",                  RT_BLOCKING_IO},
+	{"fopen",                   RT_BLOCKING_IO},
+	{"fopen64",                 RT_BLOCKING_IO},
+	{"fork",                    RT_SYSCALL},
+	{"fprintf",                 RT_BLOCKING_IO},
+	{"fputs",                   RT_BLOCKING_IO},
+	{"fread",                   RT_BLOCKING_IO},
+	{"free",                    RT_ALLOCATION},
+	{"fsync",                   RT_BLOCKING_IO},
+	{"fwrite",                  RT_BLOCKING_IO},
+	{"ioctl",                   RT_SYSCALL},
+	{"kill",                    RT_SYSCALL},
+	{"malloc",                  RT_ALLOCATION},
+	{"memalign",                RT_ALLOCATION},
+	{"mlock",                   RT_SYSCALL},
+	{"mmap",                    RT_ALLOCATION},
+	{"mmap64",                  RT_ALLOCATION},
+	{"munlock",                 RT_SYSCALL},
+	{"munmap",                  RT_ALLOCATION},
+	{"nanosleep",               RT_SLEEPING},
+	{"open",                    RT_BLOCKING_IO},
+	{"open64",                  RT_BLOCKING_IO},
+	{"perror",                  RT_BLOCKING_IO},
+	{"poll",                    RT_SLEEPING},
+	{"popen",                   RT_SYSCALL},
+	{"posix_memalign",          RT_ALLOCATION},
+	{"printf",                  RT_BLOCKING_IO},
+	{"pthread_cond_timedwait",  RT_LOCKING},
+	{"pthread_cond_wait",       RT_LOCKING},
+	{"pthread_join",            RT_LOCKING},
+	{"pthread_mutex_lock",      RT_LOCKING},
+	{"pthread_mutex_timedlock", RT_LOCKING},
+	{"pthread_rwlock_rdlock",   RT_LOCKING},
+	{"pthread_rwlock_wrlock",   RT_LOCKING},
+	{"putchar",                 RT_BLOCKING_IO},
+	{"puts",                    RT_BLOCKING_IO},
+	{"read",                    RT_BLOCKING_IO},
+	{"realloc",                 RT_ALLOCATION},
+	{"select",                  RT_SLEEPING},
+	{"sem_timedwait",           RT_LOCKING},
+	{"sem_wait",                RT_LOCKING},
+	{"sleep",                   RT_SLEEPING},
+	{"strdup",                  RT_ALLOCATION},
+	{"strndup",                 RT_ALLOCATION},
+	{"syscall",                 RT_SYSCALL},
+	{"system",                  RT_SYSCALL},
+	{"usleep",                  RT_SLEEPING},
+	{"valloc",                  RT_ALLOCATION},
+	{"vfork",                   RT_SYSCALL},
+	{"vfprintf",                RT_BLOCKING_IO},
+	{"vprintf",                 RT_BLOCKING_IO},
+	{"write",                   RT_BLOCKING_IO}
+};
+
+static int
+_rt_symbol_cmp(const void *key, const void *elmnt)
+{
+	const rt_symbol_t *rt_symbol = elmnt;
+
+	return strcmp(key, rt_symbol->name);
 }
 
 bool
-test_shared_libraries(app_t *app, const char *path, const char *uri,
-	const char *const *whitelist, unsigned n_whitelist,
-	const char *const *blacklist, unsigned n_blacklist,
-	char **libraries)
+test_rt_safety(app_t *app, const char *path, const char *uri, char **symbols)
 {
+	const unsigned n_rt_symbols = sizeof(rt_symbols) / sizeof(rt_symbol_t);
+	strbuf_t list = { .buf = NULL };
 	unsigned invalid = 0;
 
-	const int fd = open(path, O_RDONLY);
-	if(fd != -1)
+	const elf_facts_t *facts = lv2lint_elf_facts(app, path);
+	if(facts)
 	{
-		elf_version(EV_CURRENT);
-
-		Elf *elf = elf_begin(fd, ELF_C_READ, NULL);
-		if(elf)
+		// iterate over imported symbol names
+		for(unsigned i = 0; i < facts->n_imports; i++)
 		{
-			for(Elf_Scn *scn = elf_nextscn(elf, NULL);
-				scn;
-				scn = elf_nextscn(elf, scn))
+			const char *name = facts->imports[i];
+			const rt_symbol_t *rt_symbol = bsearch(name, rt_symbols, n_rt_symbols,
+				sizeof(rt_symbol_t), _rt_symbol_cmp);
+			rt_category_t category = RT_CATEGORY_MAX;
+
+			if(rt_symbol)
+			{
+				category = rt_symbol->category;
+			}
+			else if(lv2lint_matcher_match(&app->match_rt, uri, name))
+			{
+				category = RT_CUSTOM;
+			}
+
+			if(  (category == RT_CATEGORY_MAX)
+				|| lv2lint_matcher_match(&app->match_symbols, uri, name) )
+			{
+				continue;
+			}
+
+			if(invalid <= 10)
 			{
-				GElf_Shdr shdr;
-				memset(&shdr, 0x0, sizeof(GElf_Shdr));
-				gelf_getshdr(scn, &shdr);
+				const char *item = (invalid == 10)
+					? "... there is more, but the rest is being truncated"
+					: lv2lint_arena_printf(app, "%s (%s)", name, rt_categories[category]);
 
-				if(shdr.sh_type == SHT_DYNAMIC)
+				if(item)
 				{
-					// found a dynamic table
-					Elf_Data *data = elf_getdata(scn, NULL);
-					const unsigned count = shdr.sh_size / shdr.sh_entsize;
+					_append_to(&list, item);
+				}
+			}
+			invalid++;
+		}
+	}
 
-					// iterate over linked shared library names
-					for(unsigned i = 0; i < count; i++)
-					{
-						GElf_Dyn dyn;
-						memset(&dyn, 0x0, sizeof(GElf_Dyn));
-						gelf_getdyn(data, i, &dyn);
+	*symbols = lv2lint_arena_strdup(app, list.buf);
+	lv2lint_strbuf_free(&list);
 
-						if(dyn.d_tag == DT_NEEDED)
-						{
-							const char *name = elf_strptr(elf, shdr.sh_link, dyn.d_un.d_val);
+	return !invalid;
+}
 
-							bool whitelist_match = false;
-							bool blacklist_match = false;
+static const char *isa_levels [] = {
+	"x86-64",
+	"x86-64",
+	"x86-64-v2",
+	"x86-64-v3",
+	"x86-64-v4"
+};
 
-							for(unsigned j = 0; j < n_whitelist; j++)
-							{
-								if(!strncmp(name, whitelist[j], strlen(whitelist[j])))
-								{
-									whitelist_match = true;
-									break;
-								}
-							}
+static unsigned
+_isa_level(uint32_t isa)
+{
+	unsigned level = 0;
 
-							if(_white_match(app->whitelist_libs, uri, name))
-							{
-								whitelist_match = true;
-								break;
-							}
+	// bits of x86-64-baseline ... x86-64-v4
+	for(unsigned i = 0; (1U << i) <= LV2LINT_GNU_PROPERTY_X86_ISA_1_V4; i++)
+	{
+		if(isa & (1U << i))
+		{
+			level = i + 1;
+		}
+	}
 
-							for(unsigned j = 0; j < n_blacklist; j++)
-							{
-								if(!strncmp(name, blacklist[j], strlen(blacklist[j])))
-								{
-									blacklist_match = true;
-									break;
-								}
-							}
+	return level;
+}
 
-							if(n_whitelist && !whitelist_match)
-							{
-								_append_to(libraries, name);
-								invalid++;
-							}
-							if(n_blacklist && blacklist_match && !whitelist_match)
-							{
-								_append_to(libraries, name);
-								invalid++;
-							}
-						}
-						//FIXME
-					}
+static int
+_parse_isa_level(const char *str)
+{
+	const unsigned n_levels = sizeof(isa_levels) / sizeof(const char *);
 
-					break;
-				}
-			}
-			elf_end(elf);
+	for(unsigned i = 1; i < n_levels; i++)
+	{
+		if(!strcmp(str, isa_levels[i]))
+		{
+			return i;
 		}
-		close(fd);
 	}
 
-	return !invalid;
+	return -1;
+}
+
+bool
+test_isa_level(app_t *app, const char *path, char **isa)
+{
+	const unsigned baseline = app->isa_baseline ? app->isa_baseline : 1;
+	const elf_facts_t *facts = lv2lint_elf_facts(app, path);
+
+	// x86-64 levels are not defined for i386 binaries
+	if(!facts || (facts->machine != EM_X86_64) )
+	{
+		return true;
+	}
+
+	// prefer hard requirements over mere usage
+	const bool is_needed = facts->x86_isa_needed != 0;
+	const unsigned level = _isa_level(is_needed
+		? facts->x86_isa_needed
+		: facts->x86_isa_used);
+
+	if(level <= baseline)
+	{
+		return true;
+	}
+
+	const uint32_t feature_2 = facts->x86_feature_2_used;
+
+	*isa = lv2lint_arena_printf(app, "%s (%s%s%s, baseline %s)",
+		isa_levels[level], is_needed ? "needed" : "used",
+		(feature_2 & LV2LINT_GNU_PROPERTY_X86_FEATURE_2_YMM) ? ", AVX registers" : "",
+		(feature_2 & LV2LINT_GNU_PROPERTY_X86_FEATURE_2_ZMM) ? ", AVX-512 registers" : "",
+		isa_levels[baseline]);
+
+	return false;
 }
 #endif
 
@@ -1216,6 +1329,20 @@ _append_include_dir(app_t *app, char *include_dir)
 	}
 }
 
+static void
+_load_include_dir(app_t *app, const char *include_dir)
+{
+	LilvNode *bundle_node = lilv_new_file_uri(app->world, NULL, include_dir);
+
+	if(bundle_node)
+	{
+		lilv_world_load_bundle(app->world, bundle_node);
+		lilv_world_load_resource(app->world, bundle_node);
+
+		lilv_node_free(bundle_node);
+	}
+}
+
 static void
 _load_include_dirs(app_t *app)
 {
@@ -1228,15 +1355,7 @@ _load_include_dirs(app_t *app)
 			continue;
 		}
 
-		LilvNode *bundle_node = lilv_new_file_uri(app->world, NULL, include_dir);
-
-		if(bundle_node)
-		{
-			lilv_world_load_bundle(app->world, bundle_node);
-			lilv_world_load_resource(app->world, bundle_node);
-
-			lilv_node_free(bundle_node);
-		}
+		_load_include_dir(app, include_dir);
 	}
 }
 
@@ -1280,13 +1399,62 @@ _append_whitelist_test(app_t *app, const char *uri, const char *pattern)
 static void
 _free_whitelist_tests(app_t *app)
 {
+	lv2lint_matcher_deinit(&app->match_tests);
 	app->whitelist_tests = _white_free(app->whitelist_tests);
 }
 
 bool
 lv2lint_test_is_whitelisted(app_t *app, const char *uri, const test_t *test)
 {
-	return _white_match(app->whitelist_tests, uri, test->id);
+	return lv2lint_matcher_match(&app->match_tests, uri, test->id);
+}
+
+static void
+_append_select_test(app_t *app, const char *uri, const char *pattern)
+{
+	app->select_tests = _white_append(app->select_tests, uri, pattern);
+}
+
+static void
+_append_exclude_test(app_t *app, const char *uri, const char *pattern)
+{
+	app->exclude_tests = _white_append(app->exclude_tests, uri, pattern);
+}
+
+static void
+_free_select_tests(app_t *app)
+{
+	lv2lint_matcher_deinit(&app->match_select);
+	lv2lint_matcher_deinit(&app->match_exclude);
+	app->select_tests = _white_free(app->select_tests);
+	app->exclude_tests = _white_free(app->exclude_tests);
+}
+
+static bool
+_white_scoped(const white_t *white, const char *uri)
+{
+	for( ; white; white = white->next)
+	{
+		if(lv2lint_pattern_match(white->uri, uri))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool
+lv2lint_test_is_selected(app_t *app, const char *uri, const test_t *test)
+{
+	// selection only restricts URIs it has been scoped to with -u
+	if(_white_scoped(app->select_tests, uri)
+		&& !lv2lint_matcher_match(&app->match_select, uri, test->id))
+	{
+		return false;
+	}
+
+	return !lv2lint_matcher_match(&app->match_exclude, uri, test->id);
 }
 
 #ifdef ENABLE_ELF_TESTS
@@ -1299,6 +1467,7 @@ _append_whitelist_symbol(app_t *app, const char *uri, char *pattern)
 static void
 _free_whitelist_symbols(app_t *app)
 {
+	lv2lint_matcher_deinit(&app->match_symbols);
 	app->whitelist_symbols = _white_free(app->whitelist_symbols);
 }
 
@@ -1311,252 +1480,146 @@ _append_whitelist_lib(app_t *app, const char *uri, char *pattern)
 static void
 _free_whitelist_libs(app_t *app)
 {
+	lv2lint_matcher_deinit(&app->match_libs);
 	app->whitelist_libs = _white_free(app->whitelist_libs);
 }
+
+static void
+_append_blacklist_rt(app_t *app, const char *uri, char *pattern)
+{
+	app->blacklist_rt = _white_append(app->blacklist_rt, uri, pattern);
+}
+
+static void
+_free_blacklist_rt(app_t *app)
+{
+	lv2lint_matcher_deinit(&app->match_rt);
+	app->blacklist_rt = _white_free(app->blacklist_rt);
+}
 #endif
 
-int
-main(int argc, char **argv)
+static int
+_compile_whitelist(matcher_t *matcher, const white_t *white)
 {
-	static app_t app;
-	const char *uri = NULL;
-	app.atty = isatty(1);
-	app.show = LINT_FAIL | LINT_WARN; // always report failed and warned tests
-	app.mask = LINT_FAIL; // always fail at failed tests
-	app.pck = true;
-#ifdef ENABLE_ONLINE_TESTS
-	app.greet = "Dear LV2 plugin developer\n"
-		"\n"
-		"We would like to congratulate you for your efforts to have created this\n"
-		"awesome plugin for the LV2 ecosystem.\n"
-		"\n"
-		"However, we have found some minor issues where your plugin deviates from\n"
-		"the LV2 plugin specification and/or its best implementation practices.\n"
-		"By fixing those, you can make your plugin more conforming and thus likely\n"
-		"usable in more hosts and with less issues for your users.\n"
-		"\n"
-		"Kindly find below an automatically generated bug report with a summary\n"
-		"of potential issues.\n"
-		"\n"
-		"Yours sincerely\n"
-		"                                 /The unofficial LV2 inquisitorial squad/\n"
-		"\n"
-		"---\n\n";
-#endif
+	lv2lint_matcher_deinit(matcher); // server requests append to the lists
 
-	int c;
-	while( (c = getopt(argc, argv, "vhqdM:S:E:I:u:t:"
-#ifdef ENABLE_ONLINE_TESTS
-		"omg:"
-#endif
-#ifdef ENABLE_ELF_TESTS
-		"s:l:"
-#endif
-		) ) != -1)
+	return lv2lint_matcher_init(matcher, white);
+}
+
+static int
+_compile_whitelists(app_t *app)
+{
+	if(  _compile_whitelist(&app->match_tests, app->whitelist_tests)
+		|| _compile_whitelist(&app->match_select, app->select_tests)
+		|| _compile_whitelist(&app->match_exclude, app->exclude_tests) )
 	{
-		switch(c)
-		{
-			case 'v':
-				_version(argv);
-				return 0;
-			case 'h':
-				_usage(argv);
-				return 0;
-			case 'q':
-				app.quiet = true;
-				break;
-			case 'd':
-				app.debug = true;
-				break;
-			case 'I':
-				_append_include_dir(&app, optarg);
-				break;
-			case 'u':
-				uri = optarg;
-				break;
-			case 't':
-				_append_whitelist_test(&app, uri, optarg);
-				break;
+		return -1;
+	}
+
 #ifdef ENABLE_ELF_TESTS
-			case 's':
-				_append_whitelist_symbol(&app, uri, optarg);
-				break;
-			case 'l':
-				_append_whitelist_lib(&app, uri, optarg);
-				break;
-#endif
-#ifdef ENABLE_ONLINE_TESTS
-			case 'o':
-				app.online = true;
-				break;
-			case 'm':
-				app.mailto = true;
-				app.atty = false;
-				break;
-			case 'g':
-				app.greet = optarg;
-				break;
+	if(  _compile_whitelist(&app->match_symbols, app->whitelist_symbols)
+		|| _compile_whitelist(&app->match_libs, app->whitelist_libs)
+		|| _compile_whitelist(&app->match_rt, app->blacklist_rt) )
+	{
+		return -1;
+	}
 #endif
-			case 'M':
-				if(!strcmp(optarg, "pack"))
-				{
-					app.pck = true;
-				}
-
-				else if(!strcmp(optarg, "nopack"))
-				{
-					app.pck = false;
-				}
 
-				break;
-			case 'S':
-				if(!strcmp(optarg, "warn"))
-				{
-					app.show |= LINT_WARN;
-				}
-				else if(!strcmp(optarg, "note"))
-				{
-					app.show |= LINT_NOTE;
-				}
-				else if(!strcmp(optarg, "pass"))
-				{
-					app.show |= LINT_PASS;
-				}
-				else if(!strcmp(optarg, "all"))
-				{
-					app.show |= (LINT_WARN | LINT_NOTE | LINT_PASS);
-				}
+	return 0;
+}
 
-				else if(!strcmp(optarg, "nowarn"))
-				{
-					app.show &= ~LINT_WARN;
-				}
-				else if(!strcmp(optarg, "nonote"))
-				{
-					app.show &= ~LINT_NOTE;
-				}
-				else if(!strcmp(optarg, "nopass"))
-				{
-					app.show &= ~LINT_PASS;
-				}
-				else if(!strcmp(optarg, "noall"))
-				{
-					app.show &= ~(LINT_WARN | LINT_NOTE | LINT_PASS);
-				}
+static bool
+_is_in_shard(app_t *app, const char *uri)
+{
+	const uint64_t hash = lv2lint_fnv1a(LV2LINT_FNV1A_INIT, uri, strlen(uri));
 
-				break;
-			case 'E':
-				if(!strcmp(optarg, "warn"))
-				{
-					app.show |= LINT_WARN;
-					app.mask |= LINT_WARN;
-				}
-				else if(!strcmp(optarg, "note"))
-				{
-					app.show |= LINT_NOTE;
-					app.mask |= LINT_NOTE;
-				}
-				else if(!strcmp(optarg, "all"))
-				{
-					app.show |= (LINT_WARN | LINT_NOTE);
-					app.mask |= (LINT_WARN | LINT_NOTE);
-				}
+	return (hash % app->shard_num) == (app->shard_idx - 1);
+}
 
-				else if(!strcmp(optarg, "nowarn"))
-				{
-					app.show &= ~LINT_WARN;
-					app.mask &= ~LINT_WARN;
-				}
-				else if(!strcmp(optarg, "nonote"))
-				{
-					app.show &= ~LINT_NOTE;
-					app.mask &= ~LINT_NOTE;
-				}
-				else if(!strcmp(optarg, "noall"))
-				{
-					app.show &= ~(LINT_WARN | LINT_NOTE);
-					app.mask &= ~(LINT_WARN | LINT_NOTE);
-				}
+const char **
+lv2lint_collect_uris(app_t *app, const LilvPlugins *plugins, char **args,
+	unsigned n_args, unsigned *n_uris)
+{
+	const unsigned max_uris = app->all
+		? lilv_plugins_size(plugins)
+		: n_args;
+	const char **uris = calloc(max_uris + 1, sizeof(const char *));
 
-				break;
-			case '?':
-#ifdef ENABLE_ONLINE_TESTS
-				if( (optopt == 'S') || (optopt == 'E') || (optopt == 'g') )
-#else
-				if( (optopt == 'S') || (optopt == 'E') )
-#endif
-					fprintf(stderr, "Option `-%c' requires an argument.\n", optopt);
-				else if(isprint(optopt))
-					fprintf(stderr, "Unknown option `-%c'.\n", optopt);
-				else
-					fprintf(stderr, "Unknown option character `\\x%x'.\n", optopt);
-				return -1;
-			default:
-				return -1;
-		}
-	}
+	*n_uris = 0;
 
-	if(optind == argc) // no URI given
+	if(!uris)
 	{
-		_usage(argv);
-		return -1;
+		return NULL;
 	}
 
-	if(!app.quiet)
+	if(app->all)
 	{
-		_header(argv);
-	}
+		LILV_FOREACH(plugins, itr, plugins)
+		{
+			const LilvPlugin *plugin = lilv_plugins_get(plugins, itr);
+			const char *uri = lilv_node_as_uri(lilv_plugin_get_uri(plugin));
+			bool match = (n_args == 0);
 
-#ifdef ENABLE_ONLINE_TESTS
-	app.curl = curl_easy_init();
-	if(!app.curl)
-		return -1;
-#endif
+			for(unsigned i = 0; !match && (i < n_args); i++)
+			{
+				match = lv2lint_pattern_match(args[i], uri);
+			}
 
-	app.world = lilv_world_new();
-	if(!app.world)
-		return -1;
+			if(match && _is_in_shard(app, uri))
+			{
+				uris[(*n_uris)++] = uri;
+			}
+		}
+	}
+	else
+	{
+		for(unsigned i = 0; i < n_args; i++)
+		{
+			if(_is_in_shard(app, args[i]))
+			{
+				uris[(*n_uris)++] = args[i];
+			}
+		}
+	}
 
-	mapper_t *mapper = mapper_new(8192, STAT_URID_MAX, stat_uris, NULL, NULL, NULL);
-	if(!mapper)
-		return -1;
+	return uris;
+}
 
-	_map_uris(&app);
-	lilv_world_load_all(app.world);
-	_load_include_dirs(&app);
+int
+lv2lint_test_uri(app_t *app, const LilvPlugins *plugins, const char *plugin_uri)
+{
+	int ret = 0;
 
-	app.map = mapper_get_map(mapper);
-	app.unmap = mapper_get_unmap(mapper);
 	LV2_Worker_Schedule sched = {
-		.handle = &app,
+		.handle = app,
 		.schedule_work = _sched
 	};
 	LV2_Log_Log log = {
-		.handle = &app,
+		.handle = app,
 		.printf = log_printf,
 		.vprintf = log_vprintf
 	};
 	LV2_State_Make_Path mkpath = {
-		.handle = &app,
+		.handle = app,
 		.path = _mkpath
 	};
 	LV2_State_Free_Path freepath = {
-		.handle = &app,
+		.handle = app,
 		.free_path = _freepath
 	};
 	LV2_Resize_Port_Resize rsz = {
-		.data = &app,
+		.data = app,
 		.resize = _resize
 	};
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 	LV2_URI_Map_Feature urimap = {
-		.callback_data = app.map,
+		.callback_data = app->map,
 		.uri_to_id = uri_to_id
 	};
 #pragma GCC diagnostic pop
 	LV2_Inline_Display queue_draw = {
-		.handle = &app,
+		.handle = app,
 		.queue_draw = _queue_draw
 	};
 
@@ -1619,11 +1682,11 @@ main(int argc, char **argv)
 
 	const LV2_Feature feat_map = {
 		.URI = LV2_URID__map,
-		.data = app.map
+		.data = app->map
 	};
 	const LV2_Feature feat_unmap = {
 		.URI = LV2_URID__unmap,
-		.data = app.unmap
+		.data = app->unmap
 	};
 	const LV2_Feature feat_sched = {
 		.URI = LV2_WORKER__schedule,
@@ -1689,355 +1752,796 @@ main(int argc, char **argv)
 		.data = &queue_draw
 	};
 
-	int ret = 0;
-	const LilvPlugin *plugins = lilv_world_get_all_plugins(app.world);
-	if(plugins)
+	app->plugin_uri = plugin_uri;
+	app->failed_fast = false;
+	LilvNode *plugin_uri_node = lilv_new_uri(app->world, app->plugin_uri);
+	if(plugin_uri_node)
 	{
-		for(int i=optind; i<argc; i++)
+		app->plugin = lilv_plugins_get_by_uri(plugins, plugin_uri_node);
+		if(app->plugin)
 		{
-			app.plugin_uri = argv[i];
-			LilvNode *plugin_uri_node = lilv_new_uri(app.world, app.plugin_uri);
-			if(plugin_uri_node)
+#define MAX_FEATURES 21
+			const LV2_Feature *features [MAX_FEATURES];
+			bool requires_bounded_block_length = false;
+
+			// populate feature list
 			{
-				app.plugin = lilv_plugins_get_by_uri(plugins, plugin_uri_node);
-				if(app.plugin)
+				int f = 0;
+
+				LilvNodes *required_features = lilv_plugin_get_required_features(app->plugin);
+				if(required_features)
 				{
-#define MAX_FEATURES 21
-					const LV2_Feature *features [MAX_FEATURES];
-					bool requires_bounded_block_length = false;
+					LILV_FOREACH(nodes, itr, required_features)
+					{
+						const LilvNode *feature = lilv_nodes_get(required_features, itr);
+						const LV2_URID feat = app->map->map(app->map->handle, lilv_node_as_uri(feature));
 
-					// populate feature list
+						switch(feat)
+						{
+							case URID__map:
+							{
+								features[f++] = &feat_map;
+							}	break;
+							case URID__unmap:
+							{
+								features[f++] = &feat_unmap;
+							}	break;
+							case WORKER__schedule:
+							{
+								features[f++] = &feat_sched;
+							}	break;
+							case LOG__log:
+							{
+								features[f++] = &feat_log;
+							}	break;
+							case STATE__makePath:
+							{
+								features[f++] = &feat_mkpath;
+							}	break;
+							case STATE__freePath:
+							{
+								features[f++] = &feat_freepath;
+							}	break;
+							case UI__resize:
+							{
+								features[f++] = &feat_rsz;
+							}	break;
+							case OPTIONS__options:
+							{
+								features[f++] = &feat_opts;
+							}	break;
+							case URI_MAP:
+							{
+								features[f++] = &feat_urimap;
+							}	break;
+							case CORE__isLive:
+							{
+								features[f++] = &feat_islive;
+							}	break;
+							case CORE__inPlaceBroken:
+							{
+								features[f++] = &feat_inplacebroken;
+							}	break;
+							case CORE__hardRTCapable:
+							{
+								features[f++] = &feat_hardrtcapable;
+							}	break;
+							case PORT_PROPS__supportsStrictBounds:
+							{
+								features[f++] = &feat_supportsstrictbounds;
+							}	break;
+							case BUF_SIZE__boundedBlockLength:
+							{
+								features[f++] = &feat_boundedblocklength;
+								requires_bounded_block_length = true;
+							}	break;
+							case BUF_SIZE__fixedBlockLength:
+							{
+								features[f++] = &feat_fixedblocklength;
+							}	break;
+							case BUF_SIZE__powerOf2BlockLength:
+							{
+								features[f++] = &feat_powerof2blocklength;
+							}	break;
+							case BUF_SIZE__coarseBlockLength:
+							{
+								features[f++] = &feat_coarseblocklength;
+							}	break;
+							case STATE__loadDefaultState:
+							{
+								features[f++] = &feat_loaddefaultstate;
+							}	break;
+							case STATE__threadSafeRestore:
+							{
+								features[f++] = &feat_threadsaferestore;
+							}	break;
+							case INLINEDISPLAY__queue_draw:
+							{
+								features[f++] = &feat_idispqueuedraw;
+							}	break;
+						}
+					}
+					lilv_nodes_free(required_features);
+				}
+
+				features[f++] = NULL; // sentinel
+				assert(f <= MAX_FEATURES);
+			}
+
+			// populate required option list
+			{
+				unsigned n_opts = 0;
+				bool requires_min_block_length = false;
+				bool requires_max_block_length = false;
+
+				LilvNodes *required_options = lilv_plugin_get_value(app->plugin, NODE(app, OPTIONS__requiredOption));
+				if(required_options)
+				{
+					LILV_FOREACH(nodes, itr, required_options)
 					{
-						int f = 0;
+						const LilvNode *option = lilv_nodes_get(required_options, itr);
+						const LV2_URID opt = app->map->map(app->map->handle, lilv_node_as_uri(option));
 
-						LilvNodes *required_features = lilv_plugin_get_required_features(app.plugin);
-						if(required_features)
+						switch(opt)
 						{
-							LILV_FOREACH(nodes, itr, required_features)
+							case PARAMETERS__sampleRate:
+							{
+								opts[n_opts++] = opts_sampleRate;
+							} break;
+							case BUF_SIZE__minBlockLength:
 							{
-								const LilvNode *feature = lilv_nodes_get(required_features, itr);
-								const LV2_URID feat = app.map->map(app.map->handle, lilv_node_as_uri(feature));
+								opts[n_opts++] = opts_minBlockLength;
+								requires_min_block_length = true;
+							} break;
+							case BUF_SIZE__maxBlockLength:
+							{
+								opts[n_opts++] = opts_maxBlockLength;
+								requires_max_block_length = true;
+							} break;
+							case BUF_SIZE__nominalBlockLength:
+							{
+								opts[n_opts++] = opts_nominalBlockLength;
+							} break;
+							case BUF_SIZE__sequenceSize:
+							{
+								opts[n_opts++] = opts_sequenceSize;
+							} break;
+							case UI__updateRate:
+							{
+								opts[n_opts++] = opts_updateRate;
+							} break;
+						}
+					}
 
-								switch(feat)
-								{
-									case URID__map:
-									{
-										features[f++] = &feat_map;
-									}	break;
-									case URID__unmap:
-									{
-										features[f++] = &feat_unmap;
-									}	break;
-									case WORKER__schedule:
-									{
-										features[f++] = &feat_sched;
-									}	break;
-									case LOG__log:
-									{
-										features[f++] = &feat_log;
-									}	break;
-									case STATE__makePath:
-									{
-										features[f++] = &feat_mkpath;
-									}	break;
-									case STATE__freePath:
-									{
-										features[f++] = &feat_freepath;
-									}	break;
-									case UI__resize:
-									{
-										features[f++] = &feat_rsz;
-									}	break;
-									case OPTIONS__options:
-									{
-										features[f++] = &feat_opts;
-									}	break;
-									case URI_MAP:
-									{
-										features[f++] = &feat_urimap;
-									}	break;
-									case CORE__isLive:
-									{
-										features[f++] = &feat_islive;
-									}	break;
-									case CORE__inPlaceBroken:
-									{
-										features[f++] = &feat_inplacebroken;
-									}	break;
-									case CORE__hardRTCapable:
-									{
-										features[f++] = &feat_hardrtcapable;
-									}	break;
-									case PORT_PROPS__supportsStrictBounds:
-									{
-										features[f++] = &feat_supportsstrictbounds;
-									}	break;
-									case BUF_SIZE__boundedBlockLength:
-									{
-										features[f++] = &feat_boundedblocklength;
-										requires_bounded_block_length = true;
-									}	break;
-									case BUF_SIZE__fixedBlockLength:
-									{
-										features[f++] = &feat_fixedblocklength;
-									}	break;
-									case BUF_SIZE__powerOf2BlockLength:
-									{
-										features[f++] = &feat_powerof2blocklength;
-									}	break;
-									case BUF_SIZE__coarseBlockLength:
-									{
-										features[f++] = &feat_coarseblocklength;
-									}	break;
-									case STATE__loadDefaultState:
-									{
-										features[f++] = &feat_loaddefaultstate;
-									}	break;
-									case STATE__threadSafeRestore:
-									{
-										features[f++] = &feat_threadsaferestore;
-									}	break;
-									case INLINEDISPLAY__queue_draw:
-									{
-										features[f++] = &feat_idispqueuedraw;
-									}	break;
-								}
-							}
-							lilv_nodes_free(required_features);
+					lilv_nodes_free(required_options);
+				}
+
+				// handle bufsz:boundedBlockLength feature which activates options itself
+				if(requires_bounded_block_length)
+				{
+					if(!requires_min_block_length) // was not explicitely required
+						opts[n_opts++] = opts_minBlockLength;
+
+					if(!requires_max_block_length) // was not explicitely required
+						opts[n_opts++] = opts_maxBlockLength;
+				}
+
+				opts[n_opts++] = opts_sentinel; // sentinel
+				assert(n_opts <= MAX_OPTS);
+			}
+
+#ifdef ENABLE_ONLINE_TESTS
+			if(app->mailto)
+			{
+				lv2lint_strbuf_reserve(&app->mail, 0);
+			}
+#endif
+
+			lv2lint_printf(app, "%s<%s>%s\n",
+				colors[app->atty][ANSI_COLOR_BOLD],
+				lilv_node_as_uri(lilv_plugin_get_uri(app->plugin)),
+				colors[app->atty][ANSI_COLOR_RESET]);
+
+			const uint64_t t0 = lv2lint_now();
+
+			// instantiated on demand of the first test calling into the plugin
+			app->features = features;
+			app->sample_rate = param_sample_rate;
+			app->instantiated = false;
+			app->state_restored = false;
+
+			if(!test_plugin(app))
+			{
+#ifdef ENABLE_ONLINE_TESTS // only print mailto strings if errors were encountered
+				if(app->mailto && app->mail.buf && (app->format == FORMAT_TEXT) )
+				{
+					char *subj;
+					unsigned minor_version = 0;
+					unsigned micro_version = 0;
+
+					LilvNode *minor_version_nodes = lilv_plugin_get_value(app->plugin , NODE(app, CORE__minorVersion));
+					if(minor_version_nodes)
+					{
+						const LilvNode *minor_version_node = lilv_nodes_get_first(minor_version_nodes);
+						if(minor_version_node && lilv_node_is_int(minor_version_node))
+						{
+							minor_version = lilv_node_as_int(minor_version_node);
 						}
 
-						features[f++] = NULL; // sentinel
-						assert(f <= MAX_FEATURES);
+						lilv_nodes_free(minor_version_nodes);
 					}
 
-					// populate required option list
+					LilvNode *micro_version_nodes = lilv_plugin_get_value(app->plugin , NODE(app, CORE__microVersion));
+					if(micro_version_nodes)
 					{
-						unsigned n_opts = 0;
-						bool requires_min_block_length = false;
-						bool requires_max_block_length = false;
+						const LilvNode *micro_version_node = lilv_nodes_get_first(micro_version_nodes);
+						if(micro_version_node && lilv_node_is_int(micro_version_node))
+						{
+							micro_version = lilv_node_as_int(micro_version_node);
+						}
 
-						LilvNodes *required_options = lilv_plugin_get_value(app.plugin, NODE(&app, OPTIONS__requiredOption));
-						if(required_options)
+						lilv_nodes_free(micro_version_nodes);
+					}
+
+					if(asprintf(&subj, "[%s "LV2LINT_VERSION"] bug report for <%s> version %u.%u",
+						app->argv0, app->plugin_uri, minor_version, micro_version) != -1)
+					{
+						char *subj_esc = curl_easy_escape(app->curl, subj, strlen(subj));
+						if(subj_esc)
 						{
-							LILV_FOREACH(nodes, itr, required_options)
+							char *greet_esc = curl_easy_escape(app->curl, app->greet, strlen(app->greet));
+							if(greet_esc)
 							{
-								const LilvNode *option = lilv_nodes_get(required_options, itr);
-								const LV2_URID opt = app.map->map(app.map->handle, lilv_node_as_uri(option));
-
-								switch(opt)
+								char *body_esc = curl_easy_escape(app->curl, app->mail.buf, app->mail.len);
+								if(body_esc)
 								{
-									case PARAMETERS__sampleRate:
-									{
-										opts[n_opts++] = opts_sampleRate;
-									} break;
-									case BUF_SIZE__minBlockLength:
-									{
-										opts[n_opts++] = opts_minBlockLength;
-										requires_min_block_length = true;
-									} break;
-									case BUF_SIZE__maxBlockLength:
-									{
-										opts[n_opts++] = opts_maxBlockLength;
-										requires_max_block_length = true;
-									} break;
-									case BUF_SIZE__nominalBlockLength:
-									{
-										opts[n_opts++] = opts_nominalBlockLength;
-									} break;
-									case BUF_SIZE__sequenceSize:
-									{
-										opts[n_opts++] = opts_sequenceSize;
-									} break;
-									case UI__updateRate:
+									LilvNode *email_node = lilv_plugin_get_author_email(app->plugin);
+									const char *email = email_node && lilv_node_is_uri(email_node)
+										? lilv_node_as_uri(email_node)
+										: "mailto:unknown@example.com";
+
+									fprintf(app->out, "%s?subject=%s&body=%s%s\n",
+										email, subj_esc, greet_esc, body_esc);
+
+									if(email_node)
 									{
-										opts[n_opts++] = opts_updateRate;
-									} break;
+										lilv_node_free(email_node);
+									}
+
+									curl_free(body_esc);
 								}
+
+								curl_free(greet_esc);
 							}
 
-							lilv_nodes_free(required_options);
+							curl_free(subj_esc);
 						}
 
-						// handle bufsz:boundedBlockLength feature which activates options itself
-						if(requires_bounded_block_length)
-						{
-							if(!requires_min_block_length) // was not explicitely required
-								opts[n_opts++] = opts_minBlockLength;
+						free(subj);
+					}
+				}
+#endif
 
-							if(!requires_max_block_length) // was not explicitely required
-								opts[n_opts++] = opts_maxBlockLength;
-						}
+				ret += 1;
+			}
 
-						opts[n_opts++] = opts_sentinel; // sentinel
-						assert(n_opts <= MAX_OPTS);
-					}
+#ifdef ENABLE_ONLINE_TESTS
+			lv2lint_strbuf_free(&app->mail);
+#endif
+
+			if(app->instance)
+			{
+				lilv_instance_free(app->instance);
+				app->instance = NULL;
+				app->descriptor = NULL;
+				app->work_iface = NULL;
+				app->idisp_iface = NULL;
+				app->state_iface= NULL;
+				app->opts_iface = NULL;
+			}
+
+			app->features = NULL; // points to our stack
+
+			lv2lint_timings_plugin(app, app->plugin_uri, t0);
+			lv2lint_arena_reset(app); // all results of this plugin are reported
+
+			app->plugin = NULL;
 
+		}
+		else
+		{
+			ret += 1;
+		}
+	}
+	else
+	{
+		ret += 1;
+	}
+	lilv_node_free(plugin_uri_node);
+
+	return ret;
+}
+
+static int
+_parse_args(app_t *app, int argc, char **argv)
+{
+	const char *uri = NULL;
+
+	enum {
+		OPT_SHARD = 0x100,
+		OPT_SERVER,
+		OPT_CLIENT,
+		OPT_WATCH,
+		OPT_TIMINGS,
+		OPT_TRACE,
+		OPT_FORMAT,
+		OPT_FAIL_FAST,
+		OPT_ISA_BASELINE
+	};
+
+	static const struct option long_opts [] = {
+		{"shard", required_argument, NULL, OPT_SHARD},
+		{"server", required_argument, NULL, OPT_SERVER},
+		{"client", required_argument, NULL, OPT_CLIENT},
+		{"timings", no_argument, NULL, OPT_TIMINGS},
+		{"trace", required_argument, NULL, OPT_TRACE},
+		{"format", required_argument, NULL, OPT_FORMAT},
+		{"fail-fast", no_argument, NULL, OPT_FAIL_FAST},
+#if defined(HAS_INOTIFY)
+		{"watch", no_argument, NULL, OPT_WATCH},
+#endif
+#ifdef ENABLE_ELF_TESTS
+		{"isa-baseline", required_argument, NULL, OPT_ISA_BASELINE},
+#endif
+		{NULL, 0, NULL, 0}
+	};
+
+	int c;
+	while( (c = getopt_long(argc, argv, "vhqdAcFM:S:E:I:u:t:T:X:j:w:"
 #ifdef ENABLE_ONLINE_TESTS
-					if(app.mailto)
-					{
-						app.mail = calloc(1, sizeof(char));
-					}
+		"omg:"
+#endif
+#ifdef ENABLE_ELF_TESTS
+		"s:l:r:"
+#endif
+		, long_opts, NULL) ) != -1)
+	{
+		switch(c)
+		{
+			case 'v':
+				_version(argv);
+				return 1;
+			case 'h':
+				_usage(argv);
+				return 1;
+			case 'q':
+				app->quiet = true;
+				break;
+			case 'd':
+				app->debug = true;
+				break;
+			case 'I':
+				_append_include_dir(app, optarg);
+				break;
+			case 'u':
+				uri = optarg;
+				break;
+			case 't':
+				_append_whitelist_test(app, uri, optarg);
+				break;
+			case 'T':
+				_append_select_test(app, uri, optarg);
+				break;
+			case 'X':
+				_append_exclude_test(app, uri, optarg);
+				break;
+			case 'j':
+				app->n_jobs = strtoul(optarg, NULL, 10);
+				if(app->n_jobs < 1)
+				{
+					app->n_jobs = 1;
+				}
+				break;
+			case 'A':
+				app->all = true;
+				break;
+			case 'c':
+				app->use_cache = true;
+				break;
+			case 'F':
+				app->fast = true;
+				break;
+			case OPT_SERVER:
+				app->server = optarg;
+				break;
+			case OPT_CLIENT:
+				app->client = optarg;
+				break;
+			case OPT_TIMINGS:
+				app->timings = true;
+				break;
+			case OPT_TRACE:
+				app->trace = optarg;
+				break;
+			case OPT_FAIL_FAST:
+				app->fail_fast = true;
+				break;
+			case OPT_FORMAT:
+				if(lv2lint_format_parse(app, optarg))
+				{
+					fprintf(stderr, "Invalid format `%s', expected text, jsonl, junit or sarif.\n", optarg);
+					return -1;
+				}
+				break;
+#if defined(HAS_INOTIFY)
+			case OPT_WATCH:
+				app->watch = true;
+				break;
+#endif
+			case OPT_SHARD:
+				if(  (sscanf(optarg, "%u/%u", &app->shard_idx, &app->shard_num) != 2)
+					|| (app->shard_num < 1)
+					|| (app->shard_idx < 1)
+					|| (app->shard_idx > app->shard_num) )
+				{
+					fprintf(stderr, "Invalid shard `%s', expected INDEX/COUNT with 1 <= INDEX <= COUNT.\n", optarg);
+					return -1;
+				}
+				break;
+			case 'w':
+				app->sandbox = true;
+				app->timeout = strtoul(optarg, NULL, 10);
+				break;
+#ifdef ENABLE_ELF_TESTS
+			case 's':
+				_append_whitelist_symbol(app, uri, optarg);
+				break;
+			case 'l':
+				_append_whitelist_lib(app, uri, optarg);
+				break;
+			case 'r':
+				_append_blacklist_rt(app, uri, optarg);
+				break;
+			case OPT_ISA_BASELINE:
+			{
+				const int level = _parse_isa_level(optarg);
+
+				if(level < 0)
+				{
+					fprintf(stderr, "Invalid ISA baseline `%s', expected x86-64, x86-64-v2, x86-64-v3 or x86-64-v4.\n", optarg);
+					return -1;
+				}
+
+				app->isa_baseline = level;
+			} break;
+#endif
+#ifdef ENABLE_ONLINE_TESTS
+			case 'o':
+				app->online = true;
+				break;
+			case 'm':
+				app->mailto = true;
+				app->atty = false;
+				break;
+			case 'g':
+				app->greet = optarg;
+				break;
 #endif
+			case 'M':
+				if(!strcmp(optarg, "pack"))
+				{
+					app->pck = true;
+				}
 
-					lv2lint_printf(&app, "%s<%s>%s\n",
-						colors[app.atty][ANSI_COLOR_BOLD],
-						lilv_node_as_uri(lilv_plugin_get_uri(app.plugin)),
-						colors[app.atty][ANSI_COLOR_RESET]);
+				else if(!strcmp(optarg, "nopack"))
+				{
+					app->pck = false;
+				}
 
-					app.instance = lilv_plugin_instantiate(app.plugin, param_sample_rate, features);
-					app.descriptor = app.instance
-						? lilv_instance_get_descriptor(app.instance)
-						: NULL;
+				break;
+			case 'S':
+				if(!strcmp(optarg, "warn"))
+				{
+					app->show |= LINT_WARN;
+				}
+				else if(!strcmp(optarg, "note"))
+				{
+					app->show |= LINT_NOTE;
+				}
+				else if(!strcmp(optarg, "pass"))
+				{
+					app->show |= LINT_PASS;
+				}
+				else if(!strcmp(optarg, "all"))
+				{
+					app->show |= (LINT_WARN | LINT_NOTE | LINT_PASS);
+				}
 
-					if(app.instance)
-					{
-						app.work_iface = lilv_instance_get_extension_data(app.instance, LV2_WORKER__interface);
-						app.idisp_iface = lilv_instance_get_extension_data(app.instance, LV2_INLINEDISPLAY__interface);
-						app.state_iface = lilv_instance_get_extension_data(app.instance, LV2_STATE__interface);
-						app.opts_iface = lilv_instance_get_extension_data(app.instance, LV2_OPTIONS__interface);
-
-						const bool has_load_default = lilv_plugin_has_feature(app.plugin,
-							NODE(&app, STATE__loadDefaultState));
-						if(has_load_default)
-						{
-							const LilvNode *pset = lilv_plugin_get_uri(app.plugin);
+				else if(!strcmp(optarg, "nowarn"))
+				{
+					app->show &= ~LINT_WARN;
+				}
+				else if(!strcmp(optarg, "nonote"))
+				{
+					app->show &= ~LINT_NOTE;
+				}
+				else if(!strcmp(optarg, "nopass"))
+				{
+					app->show &= ~LINT_PASS;
+				}
+				else if(!strcmp(optarg, "noall"))
+				{
+					app->show &= ~(LINT_WARN | LINT_NOTE | LINT_PASS);
+				}
 
-							lilv_world_load_resource(app.world, pset);
+				break;
+			case 'E':
+				if(!strcmp(optarg, "warn"))
+				{
+					app->show |= LINT_WARN;
+					app->mask |= LINT_WARN;
+				}
+				else if(!strcmp(optarg, "note"))
+				{
+					app->show |= LINT_NOTE;
+					app->mask |= LINT_NOTE;
+				}
+				else if(!strcmp(optarg, "all"))
+				{
+					app->show |= (LINT_WARN | LINT_NOTE);
+					app->mask |= (LINT_WARN | LINT_NOTE);
+				}
 
-							LilvState *state = lilv_state_new_from_world(app.world, app.map, pset);
-							if(state)
-							{
-								lilv_state_restore(state, app.instance, _state_set_value, &app,
-									LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE, NULL); //FIXME features
+				else if(!strcmp(optarg, "nowarn"))
+				{
+					app->show &= ~LINT_WARN;
+					app->mask &= ~LINT_WARN;
+				}
+				else if(!strcmp(optarg, "nonote"))
+				{
+					app->show &= ~LINT_NOTE;
+					app->mask &= ~LINT_NOTE;
+				}
+				else if(!strcmp(optarg, "noall"))
+				{
+					app->show &= ~(LINT_WARN | LINT_NOTE);
+					app->mask &= ~(LINT_WARN | LINT_NOTE);
+				}
+
+				break;
+			case '?':
+#ifdef ENABLE_ONLINE_TESTS
+				if( (optopt == 'S') || (optopt == 'E') || (optopt == 'j') || (optopt == 'w') || (optopt == 'g') )
+#else
+				if( (optopt == 'S') || (optopt == 'E') || (optopt == 'j') || (optopt == 'w') )
+#endif
+					fprintf(stderr, "Option `-%c' requires an argument.\n", optopt);
+				else if(isprint(optopt))
+					fprintf(stderr, "Unknown option `-%c'.\n", optopt);
+				else
+					fprintf(stderr, "Unknown option character `\\x%x'.\n", optopt);
+				return -1;
+			default:
+				return -1;
+		}
+	}
+
+	if(_compile_whitelists(app))
+	{
+		fprintf(stderr, "Failed to compile whitelists.\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+_lint(app_t *app, const LilvPlugins *plugins, int argc, char **argv)
+{
+	int ret = 0;
+	unsigned n_uris = 0;
+	const uint64_t t0 = lv2lint_now();
+	const char **uris = plugins
+		? lv2lint_collect_uris(app, plugins, &argv[optind], argc - optind, &n_uris)
+		: NULL;
+	lv2lint_timing(app, TIMING_PHASE, "URI Collection", t0);
+
+	if(!uris)
+	{
+		return -1;
+	}
+
+	lv2lint_format_begin(app);
+
+	if(app->n_jobs > 1)
+	{
+		ret = lv2lint_jobs(app, plugins, uris, n_uris);
+	}
+	else
+	{
+		for(unsigned i=0; i<n_uris; i++)
+		{
+			ret += lv2lint_run_uri(app, plugins, uris[i]);
+		}
+	}
+
+	lv2lint_timings_total(app);
+	lv2lint_format_end(app, ret);
+
+	free(uris);
+
+	return ret;
+}
+
+int
+lv2lint_request(app_t *app, int argc, char **argv)
+{
+	const unsigned n_include_dirs = app->n_include_dirs;
+
+	optind = 0; // full reset of getopt state
+
+	if(_parse_args(app, argc, argv) != 0)
+	{
+		return -1;
+	}
+
+	if(!app->all && (optind == argc)) // no URI given
+	{
+		return -1;
+	}
+
+	// load additional include directories of this request only
+	for(unsigned i = n_include_dirs; i < app->n_include_dirs; i++)
+	{
+		_load_include_dir(app, app->include_dirs[i]);
+	}
+
+	if(app->use_cache && !app->cache_dir && lv2lint_cache_init(app))
+	{
+		fprintf(stderr, "Failed to initialize cache, running uncached.\n");
+	}
 
-								lilv_state_free(state);
-							}
+	const bool trace = app->trace && (app->trace_fd == -1);
 
-							lilv_world_unload_resource(app.world, pset);
-						}
-					}
+	if(trace && lv2lint_trace_open(app, app->trace))
+	{
+		return -1;
+	}
 
-					if(!test_plugin(&app))
-					{
-#ifdef ENABLE_ONLINE_TESTS // only print mailto strings if errors were encountered
-						if(app.mailto && app.mail)
-						{
-							char *subj;
-							unsigned minor_version = 0;
-							unsigned micro_version = 0;
+	const int ret = _lint(app, lilv_world_get_all_plugins(app->world), argc, argv);
 
-							LilvNode *minor_version_nodes = lilv_plugin_get_value(app.plugin , NODE(&app, CORE__minorVersion));
-							if(minor_version_nodes)
-							{
-								const LilvNode *minor_version_node = lilv_nodes_get_first(minor_version_nodes);
-								if(minor_version_node && lilv_node_is_int(minor_version_node))
-								{
-									minor_version = lilv_node_as_int(minor_version_node);
-								}
+	if(trace)
+	{
+		lv2lint_trace_close(app);
+	}
 
-								lilv_nodes_free(minor_version_nodes);
-							}
+	return ret;
+}
 
-							LilvNode *micro_version_nodes = lilv_plugin_get_value(app.plugin , NODE(&app, CORE__microVersion));
-							if(micro_version_nodes)
-							{
-								const LilvNode *micro_version_node = lilv_nodes_get_first(micro_version_nodes);
-								if(micro_version_node && lilv_node_is_int(micro_version_node))
-								{
-									micro_version = lilv_node_as_int(micro_version_node);
-								}
+int
+main(int argc, char **argv)
+{
+	static app_t app;
+	app.out = stdout;
+	app.argv0 = argv[0];
+	app.trace_fd = -1;
+	app.n_jobs = 1;
+	app.shard_idx = 1;
+	app.shard_num = 1;
+	app.atty = isatty(1);
+	app.show = LINT_FAIL | LINT_WARN; // always report failed and warned tests
+	app.mask = LINT_FAIL; // always fail at failed tests
+	app.pck = true;
+#ifdef ENABLE_ONLINE_TESTS
+	app.greet = "Dear LV2 plugin developer\n"
+		"\n"
+		"We would like to congratulate you for your efforts to have created this\n"
+		"awesome plugin for the LV2 ecosystem.\n"
+		"\n"
+		"However, we have found some minor issues where your plugin deviates from\n"
+		"the LV2 plugin specification and/or its best implementation practices.\n"
+		"By fixing those, you can make your plugin more conforming and thus likely\n"
+		"usable in more hosts and with less issues for your users.\n"
+		"\n"
+		"Kindly find below an automatically generated bug report with a summary\n"
+		"of potential issues.\n"
+		"\n"
+		"Yours sincerely\n"
+		"                                 /The unofficial LV2 inquisitorial squad/\n"
+		"\n"
+		"---\n\n";
+#endif
 
-								lilv_nodes_free(micro_version_nodes);
-							}
+	const int status = _parse_args(&app, argc, argv);
+	if(status != 0)
+	{
+		return status == 1 ? 0 : -1;
+	}
 
-							if(asprintf(&subj, "[%s "LV2LINT_VERSION"] bug report for <%s> version %u.%u",
-								argv[0], app.plugin_uri, minor_version, micro_version) != -1)
-							{
-								char *subj_esc = curl_easy_escape(app.curl, subj, strlen(subj));
-								if(subj_esc)
-								{
-									char *greet_esc = curl_easy_escape(app.curl, app.greet, strlen(app.greet));
-									if(greet_esc)
-									{
-										char *body_esc = curl_easy_escape(app.curl, app.mail, strlen(app.mail));
-										if(body_esc)
-										{
-											LilvNode *email_node = lilv_plugin_get_author_email(app.plugin);
-											const char *email = email_node && lilv_node_is_uri(email_node)
-												? lilv_node_as_uri(email_node)
-												: "mailto:unknown@example.com";
-
-											fprintf(stdout, "%s?subject=%s&body=%s%s\n",
-												email, subj_esc, greet_esc, body_esc);
-
-											if(email_node)
-											{
-												lilv_node_free(email_node);
-											}
-
-											curl_free(body_esc);
-										}
-
-										curl_free(greet_esc);
-									}
+	if(!app.all && !app.server && (optind == argc)) // no URI given
+	{
+		_usage(argv);
+		return -1;
+	}
 
-									curl_free(subj_esc);
-								}
+	if(!app.quiet)
+	{
+		_header(argv);
+	}
 
-								free(subj);
-							}
-						}
-#endif
+	if(app.client)
+	{
+		return lv2lint_client(&app, app.client, argc, argv);
+	}
 
-						ret += 1;
-					}
+	// a server traces each request on its own
+	if(app.trace && !app.server && lv2lint_trace_open(&app, app.trace))
+	{
+		return -1;
+	}
 
 #ifdef ENABLE_ONLINE_TESTS
-					if(app.mail)
-					{
-						free(app.mail);
-						app.mail = NULL;
-					}
+	app.curl = curl_easy_init();
+	if(!app.curl)
+		return -1;
 #endif
 
-					if(app.instance)
-					{
-						lilv_instance_free(app.instance);
-						app.instance = NULL;
-						app.descriptor = NULL;
-						app.work_iface = NULL;
-						app.idisp_iface = NULL;
-						app.state_iface= NULL;
-						app.opts_iface = NULL;
-					}
+	app.world = lilv_world_new();
+	if(!app.world)
+		return -1;
 
-					app.plugin = NULL;
+	mapper_t *mapper = mapper_new(8192, STAT_URID_MAX, stat_uris, NULL, NULL, NULL);
+	if(!mapper)
+		return -1;
 
-				}
-				else
-				{
-					ret += 1;
-				}
-			}
-			else
-			{
-				ret += 1;
-			}
-			lilv_node_free(plugin_uri_node);
-		}
+	_map_uris(&app);
+	const uint64_t t0 = lv2lint_now();
+	if(app.fast && !app.all && !app.server)
+	{
+		lv2lint_load_bundles(&app, (const char **)&argv[optind], argc - optind);
+		_load_include_dirs(&app);
+		lilv_world_load_specifications(app.world);
+		lilv_world_load_plugin_classes(app.world);
 	}
 	else
 	{
-		ret = -1;
+		lilv_world_load_all(app.world);
+		_load_include_dirs(&app);
+	}
+	lv2lint_timing(&app, TIMING_PHASE, "World Load", t0);
+
+	app.map = mapper_get_map(mapper);
+	app.unmap = mapper_get_unmap(mapper);
+
+	if(app.use_cache && lv2lint_cache_init(&app))
+	{
+		fprintf(stderr, "Failed to initialize cache, running uncached.\n");
+	}
+
+	int ret = app.server
+		? lv2lint_server(&app, app.server)
+		: _lint(&app, lilv_world_get_all_plugins(app.world), argc, argv);
+
+#if defined(HAS_INOTIFY)
+	if(app.watch && !app.server)
+	{
+		ret = lv2lint_watch(&app, &argv[optind], argc - optind);
 	}
+#endif
 
 	_unmap_uris(&app);
 	_free_urids(&app);
 	_free_include_dirs(&app);
+	lv2lint_cache_deinit(&app);
+	lv2lint_trace_close(&app);
+	lv2lint_arena_free(&app);
 	_free_whitelist_tests(&app);
+	_free_select_tests(&app);
 #ifdef ENABLE_ELF_TESTS
 	_free_whitelist_symbols(&app);
 	_free_whitelist_libs(&app);
+	_free_blacklist_rt(&app);
+	lv2lint_elf_free(&app);
 #endif
 	mapper_free(mapper);
 
@@ -2054,30 +2558,15 @@ int
 lv2lint_vprintf(app_t *app, const char *fmt, va_list args)
 {
 #ifdef ENABLE_ONLINE_TESTS
-	if(app->mailto)
+	if(app->mailto && app->mail.buf)
 	{
-		char *buf = NULL;
-		int len;
-
-		if( (len = vasprintf(&buf, fmt, args)) != -1)
-		{
-			len += strlen(app->mail);
-			app->mail = realloc(app->mail, len + 1);
-
-			if(app->mail)
-			{
-				app->mail = strncat(app->mail, buf, len + 1);
-			}
-
-			free(buf);
-		}
+		lv2lint_strbuf_vprintf(&app->mail, fmt, args);
 	}
 	else
-#else
-	(void)app;
 #endif
+	if(app->format == FORMAT_TEXT) // report sinks write on their own
 	{
-		vfprintf(stdout, fmt, args);
+		vfprintf(app->out, fmt, args);
 	}
 
 	return 0;
@@ -2173,6 +2662,18 @@ static void
 _report_body(app_t *app, const char *label, ansi_color_t col, const test_t *test,
 	const ret_t *ret, const char *repl, char *docu)
 {
+	if(app->format != FORMAT_TEXT)
+	{
+		if(docu)
+		{
+			_escape_markup(docu);
+		}
+
+		lv2lint_format_result(app, test, label, lv2lint_extract(app, ret), ret,
+			repl ? repl : ret->msg, docu);
+		return;
+	}
+
 	_report_head(app, label, col, test);
 
 	lv2lint_printf(app, "              %s\n", repl ? repl : ret->msg);
@@ -2193,11 +2694,193 @@ _report_body(app_t *app, const char *label, ansi_color_t col, const test_t *test
 	lv2lint_printf(app, "              seeAlso: <%s>\n", ret->uri);
 }
 
+static void
+_instantiate(app_t *app)
+{
+	app->instantiated = true;
+
+	if(!app->features) // not within lv2lint_test_uri
+	{
+		return;
+	}
+
+	const uint64_t t0 = lv2lint_now();
+	app->instance = lilv_plugin_instantiate(app->plugin, app->sample_rate,
+		app->features);
+	lv2lint_timing(app, TIMING_PHASE, "Instantiation", t0);
+
+	if(!app->instance)
+	{
+		return;
+	}
+
+	app->descriptor = lilv_instance_get_descriptor(app->instance);
+	app->work_iface = lilv_instance_get_extension_data(app->instance, LV2_WORKER__interface);
+	app->idisp_iface = lilv_instance_get_extension_data(app->instance, LV2_INLINEDISPLAY__interface);
+	app->state_iface = lilv_instance_get_extension_data(app->instance, LV2_STATE__interface);
+	app->opts_iface = lilv_instance_get_extension_data(app->instance, LV2_OPTIONS__interface);
+}
+
+static void
+_restore_default_state(app_t *app)
+{
+	app->state_restored = true;
+
+	const bool has_load_default = app->snapshot.features[STATE__loadDefaultState];
+	if(!app->instance || !has_load_default)
+	{
+		return;
+	}
+
+	const LilvNode *pset = lilv_plugin_get_uri(app->plugin);
+
+	const uint64_t t0 = lv2lint_now();
+	lilv_world_load_resource(app->world, pset);
+
+	LilvState *state = lilv_state_new_from_world(app->world, app->map, pset);
+	if(state)
+	{
+		lilv_state_restore(state, app->instance, _state_set_value, app,
+			LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE, NULL); //FIXME features
+
+		lilv_state_free(state);
+	}
+
+	lilv_world_unload_resource(app->world, pset);
+	lv2lint_timing(app, TIMING_PHASE, "State Restore", t0);
+}
+
+void
+lv2lint_acquire(app_t *app, needs_t needs)
+{
+	if( (needs & (NEEDS_INSTANCE | WANTS_INSTANCE)) && !app->instantiated)
+	{
+		_instantiate(app);
+	}
+
+	if( (needs & NEEDS_INSTANCE) && !app->state_restored)
+	{
+		_restore_default_state(app);
+	}
+}
+
+static bool
+_has_needs(app_t *app, needs_t needs)
+{
+	lv2lint_acquire(app, needs);
+
+	if( (needs & NEEDS_UI) && !app->ui_descriptor)
+	{
+		return false;
+	}
+
+	if(needs & NEEDS_BINARY)
+	{
+		const LilvNode *node = app->ui
+			? lilv_ui_get_binary_uri(app->ui)
+			: lilv_plugin_get_library_uri(app->plugin);
+		char *path = node && lilv_node_is_uri(node)
+			? lilv_file_uri_parse(lilv_node_as_uri(node), NULL)
+			: NULL;
+		const bool readable = path && (access(path, R_OK) == 0);
+
+		if(path)
+		{
+			lilv_free(path);
+		}
+
+		if(!readable)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool
+lv2lint_run_tests(app_t *app, const char *uri, const test_t *tests,
+	unsigned tests_n, res_t *rets)
+{
+	unsigned *order = alloca(tests_n * sizeof(unsigned));
+	bool msg = false;
+
+	// run cheap tests first, keep table order within the same cost class
+	for(unsigned i = 0; i < tests_n; i++)
+	{
+		unsigned j = i;
+
+		for( ; (j > 0) && (tests[order[j - 1]].cost > tests[i].cost); j--)
+		{
+			order[j] = order[j - 1];
+		}
+
+		order[j] = i;
+	}
+
+	for(unsigned o = 0; o < tests_n; o++)
+	{
+		const test_t *test = &tests[order[o]];
+		res_t *res = &rets[order[o]];
+
+		res->is_whitelisted = lv2lint_test_is_whitelisted(app, uri, test);
+		res->is_skipped = app->failed_fast
+			|| !lv2lint_test_is_selected(app, uri, test)
+			|| !_has_needs(app, test->needs);
+		res->urn = NULL;
+		res->ret = NULL;
+
+		if(res->is_skipped)
+		{
+			continue;
+		}
+
+		app->urn = &res->urn;
+		res->ret = lv2lint_run_test(app, test);
+		const lint_t lnt = lv2lint_extract(app, res->ret);
+		if(lnt & app->show)
+		{
+			msg = true;
+		}
+
+		if(app->fail_fast && !res->is_whitelisted && (lnt & app->mask) )
+		{
+			app->failed_fast = true;
+		}
+	}
+
+	return msg;
+}
+
+needs_t
+lv2lint_tests_needs(app_t *app, const char *uri, const test_t *tests,
+	unsigned tests_n)
+{
+	needs_t needs = NEEDS_NONE;
+
+	for(unsigned i = 0; i < tests_n; i++)
+	{
+		const test_t *test = &tests[i];
+
+		if(lv2lint_test_is_selected(app, uri, test))
+		{
+			needs |= test->needs;
+		}
+	}
+
+	return needs;
+}
+
 void
 lv2lint_report(app_t *app, const test_t *test, res_t *res, bool show_passes, bool *flag)
 {
 	const ret_t *ret = res->ret;
 
+	if(res->is_skipped)
+	{
+		return;
+	}
+
 	if(ret)
 	{
 		char *repl = NULL;
@@ -2206,8 +2889,7 @@ lv2lint_report(app_t *app, const test_t *test, res_t *res, bool show_passes, boo
 		{
 			if(strstr(ret->msg, "%s"))
 			{
-				if(asprintf(&repl, ret->msg, res->urn) == -1)
-					repl = NULL;
+				repl = lv2lint_arena_printf(app, ret->msg, res->urn);
 			}
 		}
 
@@ -2217,7 +2899,7 @@ lv2lint_report(app_t *app, const test_t *test, res_t *res, bool show_passes, boo
 		{
 			if(ret->dsc)
 			{
-				docu = lv2lint_strdup(ret->dsc);
+				docu = lv2lint_arena_strdup(app, ret->dsc);
 			}
 			else
 			{
@@ -2227,7 +2909,7 @@ lv2lint_report(app_t *app, const test_t *test, res_t *res, bool show_passes, boo
 					LilvNode *docu_node = lilv_world_get(app->world, subj_node, NODE(app, CORE__documentation), NULL);
 					if(docu_node)
 					{
-						docu = lv2lint_node_as_string_strdup(docu_node);
+						docu = lv2lint_node_as_string_strdup(app, docu_node);
 
 						lilv_node_free(docu_node);
 					}
@@ -2259,16 +2941,6 @@ lv2lint_report(app_t *app, const test_t *test, res_t *res, bool show_passes, boo
 			}
 		}
 
-		if(docu)
-		{
-			free(docu);
-		}
-
-		if(repl)
-		{
-			free(repl);
-		}
-
 		if(res->is_whitelisted)
 		{
 			return; // short-circuit here
@@ -2281,7 +2953,14 @@ lv2lint_report(app_t *app, const test_t *test, res_t *res, bool show_passes, boo
 	}
 	else if(show_passes)
 	{
-		_report_head(app, "PASS", ANSI_COLOR_GREEN, test);
+		if(app->format != FORMAT_TEXT)
+		{
+			lv2lint_format_result(app, test, "PASS", LINT_PASS, NULL, NULL, NULL);
+		}
+		else
+		{
+			_report_head(app, "PASS", ANSI_COLOR_GREEN, test);
+		}
 	}
 }
 
@@ -2299,7 +2978,7 @@ lv2lint_extract(app_t *app, const ret_t *ret)
 }
 
 char *
-lv2lint_node_as_string_strdup(const LilvNode *node)
+lv2lint_node_as_string_strdup(app_t *app, const LilvNode *node)
 {
 	if(!node)
 	{
@@ -2318,11 +2997,11 @@ lv2lint_node_as_string_strdup(const LilvNode *node)
 		return NULL;
 	}
 
-	return lv2lint_strdup(str);
+	return lv2lint_arena_strdup(app, str);
 }
 
 char *
-lv2lint_node_as_uri_strdup(const LilvNode *node)
+lv2lint_node_as_uri_strdup(app_t *app, const LilvNode *node)
 {
 	if(!node)
 	{
@@ -2336,7 +3015,49 @@ lv2lint_node_as_uri_strdup(const LilvNode *node)
 
 	const char *uri = lilv_node_as_uri(node);
 
-	return lv2lint_strdup(uri);
+	return lv2lint_arena_strdup(app, uri);
+}
+
+char *
+lv2lint_node_as_key_strdup(app_t *app, const LilvNode *node)
+{
+	if(!node)
+	{
+		return NULL;
+	}
+
+	// numerically equal literals (e.g. 1 and 1.0) get the same key
+	if(lilv_node_is_int(node))
+	{
+		return lv2lint_arena_printf(app, "%i", lilv_node_as_int(node));
+	}
+	else if(lilv_node_is_float(node))
+	{
+		const float val = lilv_node_as_float(node);
+
+		if( (rintf(val) == val) && (fabsf(val) < INT32_MAX) )
+		{
+			return lv2lint_arena_printf(app, "%i", (int)val);
+		}
+
+		return lv2lint_arena_printf(app, "%.9g", val);
+	}
+
+	return lv2lint_arena_strdup(app, lilv_node_as_string(node));
+}
+
+uint64_t
+lv2lint_fnv1a(uint64_t hash, const void *data, size_t len)
+{
+	const uint8_t *ptr = data;
+
+	for(size_t i = 0; i < len; i++)
+	{
+		hash ^= ptr[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
 }
 
 char *
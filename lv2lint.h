@@ -19,6 +19,7 @@
 #define _LV2LINT_H
 
 #include <unistd.h> // isatty
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -52,6 +53,20 @@
 
 #define NODE(APP, ID) (APP)->nodes[ID]
 
+#define LV2LINT_FNV1A_INIT 0xcbf29ce484222325ULL
+
+#ifdef ENABLE_ELF_TESTS
+// .note.gnu.property values as of binutils 2.36, <elf.h> of glibc < 2.28 lacks
+// them and the one of glibc < 2.33 has the superseded x86 ISA layout
+#	define LV2LINT_NT_GNU_PROPERTY_TYPE_0          5
+#	define LV2LINT_GNU_PROPERTY_X86_ISA_1_NEEDED   0xc0008002
+#	define LV2LINT_GNU_PROPERTY_X86_ISA_1_USED     0xc0010002
+#	define LV2LINT_GNU_PROPERTY_X86_FEATURE_2_USED 0xc0010001
+#	define LV2LINT_GNU_PROPERTY_X86_ISA_1_V4       (1U << 3)
+#	define LV2LINT_GNU_PROPERTY_X86_FEATURE_2_YMM  (1U << 4)
+#	define LV2LINT_GNU_PROPERTY_X86_FEATURE_2_ZMM  (1U << 5)
+#endif
+
 typedef enum _ansi_color_t {
 	ANSI_COLOR_BOLD,
 	ANSI_COLOR_RED,
@@ -74,7 +89,50 @@ typedef struct _app_t app_t;
 typedef struct _test_t test_t;
 typedef struct _ret_t ret_t;
 typedef struct _res_t res_t;
+typedef struct _timing_t timing_t;
+typedef struct _slowest_t slowest_t;
+typedef struct _timings_t timings_t;
+typedef struct _strbuf_t strbuf_t;
+typedef struct _arena_t arena_t;
+typedef struct _arena_chunk_t arena_chunk_t;
+typedef struct _hash_entry_t hash_entry_t;
+typedef struct _hashset_t hashset_t;
+typedef struct _trie_node_t trie_node_t;
+typedef struct _matcher_t matcher_t;
+typedef struct _port_info_t port_info_t;
+typedef struct _snapshot_t snapshot_t;
+typedef struct _elf_section_t elf_section_t;
+typedef struct _elf_table_t elf_table_t;
+typedef struct _elf_facts_t elf_facts_t;
 typedef const ret_t *(*test_cb_t)(app_t *app);
+typedef int (*lv2lint_run_t)(app_t *app, const LilvPlugins *plugins, const char *uri);
+
+typedef enum _format_t {
+	FORMAT_TEXT,
+	FORMAT_JSONL,
+	FORMAT_JUNIT,
+	FORMAT_SARIF,
+
+	FORMAT_MAX
+} format_t;
+
+typedef enum _cost_t {
+	COST_META,    // metadata only
+	COST_ELF,     // parses plugin or UI binary
+	COST_RUNTIME, // calls into plugin or UI instance
+	COST_NETWORK, // online requests
+	COST_X11,     // needs X11 display
+
+	COST_MAX
+} cost_t;
+
+typedef enum _needs_t {
+	NEEDS_NONE     = 0,
+	NEEDS_BINARY   = (1 << 0), // readable plugin or UI binary
+	NEEDS_INSTANCE = (1 << 1), // instantiated with default state, runs without instance
+	NEEDS_UI       = (1 << 2), // loaded UI descriptor
+	WANTS_INSTANCE = (1 << 3)  // instantiation attempted, runs without instance
+} needs_t;
 
 typedef enum _lint_t {
 	LINT_NONE     = 0,
@@ -106,6 +164,82 @@ struct _res_t {
 	const ret_t *ret;
 	char *urn;
 	bool is_whitelisted;
+	bool is_skipped;
+};
+
+#define MAX_TIMINGS 128
+#define MAX_SLOWEST 10
+
+typedef enum _timing_kind_t {
+	TIMING_PHASE,
+	TIMING_TEST,
+
+	TIMING_KIND_MAX
+} timing_kind_t;
+
+struct _timing_t {
+	const char *id;
+	timing_kind_t kind;
+	uint64_t count;
+	uint64_t ns;
+	uint64_t max_ns;
+};
+
+struct _slowest_t {
+	uint64_t ns;
+	char uri [256];
+};
+
+struct _timings_t {
+	unsigned n_timings;
+	timing_t timings [MAX_TIMINGS];
+	unsigned n_plugins;
+	uint64_t ns;
+	unsigned n_slowest;
+	slowest_t slowest [MAX_SLOWEST];
+};
+
+struct _strbuf_t {
+	char *buf;
+	size_t len;
+	size_t cap;
+};
+
+struct _arena_t {
+	arena_chunk_t *head;
+	arena_chunk_t *cur;
+};
+
+struct _hash_entry_t {
+	const char *key; // not owned, NULL for empty slots
+	uint32_t hash;
+	uint32_t idx;
+};
+
+struct _hashset_t {
+	uint32_t mask;
+	uint32_t n_entries;
+	hash_entry_t *entries;
+};
+
+struct _trie_node_t {
+	trie_node_t *child;
+	trie_node_t *sibling;
+	uint32_t n_whites;
+	const white_t **whites; // patterns with literal prefix ending here
+	char c;
+};
+
+// whitelist compiled into exact, literal prefix and glob patterns
+struct _matcher_t {
+	hashset_t exact;
+	uint32_t n_exact;
+	char **exact_keys; // case folded
+	const white_t **exact_whites;
+	uint32_t *exact_next; // next exact pattern with same key, circular
+	trie_node_t *prefixes;
+	uint32_t n_globs;
+	const white_t **globs;
 };
 
 union _var_t {
@@ -563,6 +697,90 @@ typedef enum _stat_urid_t {
 	STAT_URID_MAX
 } stat_urid_t;
 
+typedef enum _port_is_t {
+	PORT_IS_INPUT         = (1 << 0),
+	PORT_IS_OUTPUT        = (1 << 1),
+	PORT_IS_CONTROL       = (1 << 2),
+	PORT_IS_AUDIO         = (1 << 3),
+	PORT_IS_CV            = (1 << 4),
+	PORT_IS_ATOM          = (1 << 5),
+	PORT_IS_EVENT         = (1 << 6),
+	PORT_IS_MORPH         = (1 << 7),
+	PORT_IS_AUTO_MORPH    = (1 << 8),
+	PORT_IS_INTEGER       = (1 << 9),  // lv2:portProperty
+	PORT_IS_TOGGLED       = (1 << 10), // lv2:portProperty
+	PORT_IS_SAMPLE_RATE   = (1 << 11), // lv2:portProperty
+	PORT_IS_PATCH_MESSAGE = (1 << 12)  // atom:supports patch:Message
+} port_is_t;
+
+struct _port_info_t {
+	const LilvPort *port;
+	const LilvNode *symbol;
+	uint32_t index;
+	uint32_t is; // port_is_t
+	uint32_t symbol_next; // next port with same symbol, circular
+	LilvNode *dflt;
+	LilvNode *min;
+	LilvNode *max;
+};
+
+// per-plugin metadata queried once and shared by all tests
+struct _snapshot_t {
+	bool features [STAT_URID_MAX]; // lv2:requiredFeature or lv2:optionalFeature
+	bool extensions [STAT_URID_MAX]; // lv2:extensionData
+	uint32_t n_ports;
+	port_info_t *ports;
+	LilvNodes *writables;
+	LilvNodes *readables;
+	LilvNodes *port_classes; // all subclasses of lv2:Port
+	LilvNodes *port_properties; // all lv2:PortProperty
+};
+
+struct _elf_section_t {
+	const char *name;
+	uint32_t type;
+	uint64_t flags;
+	uint64_t size;
+};
+
+struct _elf_table_t {
+	const uint8_t *data; // NULL if not present
+	uint64_t size;
+	uint64_t entsize;
+};
+
+// facts of an ELF binary gathered in a single pass, cached per path and inode
+struct _elf_facts_t {
+	elf_facts_t *next;
+	char *path;
+	uint64_t dev;
+	uint64_t ino;
+	int64_t mtime;
+	int64_t size;
+	void *map; // mapped or read binary, all names below point into it
+	size_t map_size;
+	bool is_mapped;
+	bool is_64;
+	bool is_msb;
+	uint16_t machine;
+	uint32_t n_exports;
+	const char **exports; // defined globals of first symbol table
+	uint32_t n_imports;
+	const char **imports; // undefined symbols of dynamic symbol table
+	uint32_t n_needed;
+	const char **needed; // DT_NEEDED of first dynamic section
+	uint32_t n_sections;
+	elf_section_t *sections;
+	elf_table_t dynsym;
+	elf_table_t dynstr;
+	elf_table_t hash; // DT_HASH of dynsym
+	elf_table_t gnu_hash; // DT_GNU_HASH of dynsym
+	hashset_t symbols; // names not covered by hash and gnu_hash
+	uint32_t x86_isa_needed; // .note.gnu.property
+	uint32_t x86_isa_used;
+	uint32_t x86_feature_2_used;
+};
+
 struct _app_t {
 	LilvWorld *world;
 	const char *plugin_uri;
@@ -578,8 +796,8 @@ struct _app_t {
 	LV2_URID_Unmap *unmap;
 	void *ui_instance;
 	uintptr_t ui_widget;
-	LilvNodes *writables;
-	LilvNodes *readables;
+	snapshot_t snapshot;
+	const port_info_t *port_info;
 	const LV2_Worker_Interface *work_iface;
 	const LV2_Inline_Display_Interface *idisp_iface;
 	const LV2_State_Interface *state_iface;
@@ -587,6 +805,10 @@ struct _app_t {
 	const LV2UI_Idle_Interface *ui_idle_iface;
 	const LV2UI_Show_Interface *ui_show_iface;
 	const LV2UI_Resize *ui_resize_iface;
+	const LV2_Feature *const *features;
+	float sample_rate;
+	bool instantiated;
+	bool state_restored;
 	var_t min;
 	var_t max;
 	var_t dflt;
@@ -600,13 +822,52 @@ struct _app_t {
 	char **include_dirs;
 	white_t *whitelist_symbols;
 	white_t *whitelist_libs;
+	white_t *blacklist_rt;
 	white_t *whitelist_tests;
+	white_t *select_tests;
+	white_t *exclude_tests;
+	matcher_t match_symbols;
+	matcher_t match_libs;
+	matcher_t match_rt;
+	matcher_t match_tests;
+	matcher_t match_select;
+	matcher_t match_exclude;
 	bool atty;
 	bool debug;
 	bool quiet;
+	FILE *out;
+	const char *argv0;
+	unsigned n_jobs;
+	bool sandbox;
+	unsigned timeout;
+	bool all;
+	unsigned shard_idx;
+	unsigned shard_num;
+	char *cache_dir;
+	bool no_cache;
+	bool use_cache;
+	bool fast;
+	const char *server;
+	const char *client;
+	bool watch;
+	bool timings;
+	timings_t timings_plugin;
+	timings_t timings_total;
+	const char *trace;
+	int trace_fd;
+	const char *test_id;
+	format_t format;
+	FILE *format_out; // underlying output while records are filtered
+	arena_t arena;
+	bool fail_fast;
+	bool failed_fast;
+#ifdef ENABLE_ELF_TESTS
+	elf_facts_t *elf_facts;
+	unsigned isa_baseline; // x86-64 microarchitecture level, 0 for baseline
+#endif
 #ifdef ENABLE_ONLINE_TESTS
 	bool online;
-	char *mail;
+	strbuf_t mail;
 	bool mailto;
 	CURL *curl;
 	char *greet;
@@ -617,6 +878,8 @@ struct _app_t {
 struct _test_t {
 	const char *id;
 	test_cb_t cb;
+	cost_t cost;
+	needs_t needs;
 };
 
 bool
@@ -634,8 +897,138 @@ test_ui(app_t *app);
 #ifdef ENABLE_X11_TESTS
 void
 test_x11(app_t *app, bool *flag);
+
+needs_t
+test_x11_needs(app_t *app);
+#endif
+
+int
+lv2lint_test_uri(app_t *app, const LilvPlugins *plugins, const char *plugin_uri);
+
+int
+lv2lint_sandbox(app_t *app, const LilvPlugins *plugins, const char *plugin_uri);
+
+int
+lv2lint_run_uri(app_t *app, const LilvPlugins *plugins, const char *uri);
+
+char *
+lv2lint_cache_dir_new(void);
+
+int
+lv2lint_cache_init(app_t *app);
+
+void
+lv2lint_cache_deinit(app_t *app);
+
+int
+lv2lint_cache_run(app_t *app, const LilvPlugins *plugins, const char *uri,
+	lv2lint_run_t run);
+
+int
+lv2lint_snapshot_init(app_t *app);
+
+void
+lv2lint_snapshot_deinit(app_t *app);
+
+uint32_t
+lv2lint_hash(const char *str);
+
+int
+lv2lint_hashset_init(hashset_t *set, uint32_t n_keys);
+
+void
+lv2lint_hashset_deinit(hashset_t *set);
+
+hash_entry_t *
+lv2lint_hashset_insert(hashset_t *set, const char *key, uint32_t idx,
+	bool *is_new);
+
+const hash_entry_t *
+lv2lint_hashset_lookup(const hashset_t *set, const char *key);
+
+char *
+lv2lint_duplicates(app_t *app, const char *const *keys, uint32_t n_keys);
+
+bool
+lv2lint_pattern_match(const char *pattern, const char *str);
+
+int
+lv2lint_matcher_init(matcher_t *matcher, const white_t *white);
+
+void
+lv2lint_matcher_deinit(matcher_t *matcher);
+
+bool
+lv2lint_matcher_match(const matcher_t *matcher, const char *uri, const char *str);
+
+void
+lv2lint_load_bundles(app_t *app, const char **uris, unsigned n_uris);
+
+const char **
+lv2lint_collect_uris(app_t *app, const LilvPlugins *plugins, char **args,
+	unsigned n_args, unsigned *n_uris);
+
+int
+lv2lint_request(app_t *app, int argc, char **argv);
+
+#if defined(HAS_INOTIFY)
+int
+lv2lint_watch(app_t *app, char **args, unsigned n_args);
 #endif
 
+int
+lv2lint_server(app_t *app, const char *path);
+
+int
+lv2lint_client(app_t *app, const char *path, int argc, char **argv);
+
+uint64_t
+lv2lint_now(void);
+
+void
+lv2lint_timing(app_t *app, timing_kind_t kind, const char *id, uint64_t t0);
+
+const ret_t *
+lv2lint_run_test(app_t *app, const test_t *test);
+
+void
+lv2lint_timings_merge(timings_t *dst, const timings_t *src);
+
+void
+lv2lint_timings_plugin(app_t *app, const char *uri, uint64_t t0);
+
+void
+lv2lint_timings_total(app_t *app);
+
+int
+lv2lint_format_parse(app_t *app, const char *name);
+
+void
+lv2lint_format_begin(app_t *app);
+
+void
+lv2lint_format_result(app_t *app, const test_t *test, const char *label,
+	lint_t lnt, const ret_t *ret, const char *msg, const char *docu);
+
+void
+lv2lint_format_end(app_t *app, int ret);
+
+int
+lv2lint_trace_open(app_t *app, const char *path);
+
+void
+lv2lint_trace_close(app_t *app);
+
+void
+lv2lint_trace_process(app_t *app, const char *name);
+
+void
+lv2lint_trace_event(app_t *app, const char *cat, const char *name,
+	uint64_t t0, uint64_t t1);
+
+int
+lv2lint_jobs(app_t *app, const LilvPlugins *plugins, const char **uris, unsigned n_uris);
+
 #ifdef ENABLE_ONLINE_TESTS
 bool
 is_url(const char *uri);
@@ -645,6 +1038,15 @@ test_url(app_t *app, const char *url);
 #endif
 
 #ifdef ENABLE_ELF_TESTS
+const elf_facts_t *
+lv2lint_elf_facts(app_t *app, const char *path);
+
+bool
+lv2lint_elf_has_symbol(const elf_facts_t *facts, const char *name);
+
+void
+lv2lint_elf_free(app_t *app);
+
 bool
 test_visibility(app_t *app, const char *path, const char *uri,
 	const char *description, char **symbols);
@@ -657,6 +1059,12 @@ test_shared_libraries(app_t *app, const char *path, const char *uri,
 	const char *const *whitelist, unsigned n_whitelist,
 	const char *const *blacklist, unsigned n_blacklist,
 	char **libraries);
+
+bool
+test_rt_safety(app_t *app, const char *path, const char *uri, char **symbols);
+
+bool
+test_isa_level(app_t *app, const char *path, char **isa);
 #endif
 
 int
@@ -665,6 +1073,17 @@ lv2lint_vprintf(app_t *app, const char *fmt, va_list args);
 int
 lv2lint_printf(app_t *app, const char *fmt, ...);
 
+bool
+lv2lint_run_tests(app_t *app, const char *uri, const test_t *tests,
+	unsigned tests_n, res_t *rets);
+
+void
+lv2lint_acquire(app_t *app, needs_t needs);
+
+needs_t
+lv2lint_tests_needs(app_t *app, const char *uri, const test_t *tests,
+	unsigned tests_n);
+
 void
 lv2lint_report(app_t *app, const test_t *test, res_t *res, bool show_passes, bool *flag);
 
@@ -674,15 +1093,71 @@ lv2lint_extract(app_t *app, const ret_t *ret);
 bool
 lv2lint_test_is_whitelisted(app_t *app, const char *uri, const test_t *test);
 
+bool
+lv2lint_test_is_selected(app_t *app, const char *uri, const test_t *test);
+
 char *
-lv2lint_node_as_string_strdup(const LilvNode *node);
+lv2lint_node_as_string_strdup(app_t *app, const LilvNode *node);
 
 char *
-lv2lint_node_as_uri_strdup(const LilvNode *node);
+lv2lint_node_as_uri_strdup(app_t *app, const LilvNode *node);
+
+char *
+lv2lint_node_as_key_strdup(app_t *app, const LilvNode *node);
 
 char *
 lv2lint_strdup(const char *str);
 
+void *
+lv2lint_arena_alloc(app_t *app, size_t len);
+
+char *
+lv2lint_arena_strdup(app_t *app, const char *str);
+
+char *
+lv2lint_arena_vprintf(app_t *app, const char *fmt, va_list args);
+
+char *
+lv2lint_arena_printf(app_t *app, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+
+void
+lv2lint_arena_reset(app_t *app);
+
+void
+lv2lint_arena_free(app_t *app);
+
+int
+lv2lint_strbuf_reserve(strbuf_t *sb, size_t len);
+
+int
+lv2lint_strbuf_append(strbuf_t *sb, const char *str, size_t len);
+
+int
+lv2lint_strbuf_puts(strbuf_t *sb, const char *str);
+
+int
+lv2lint_strbuf_putc(strbuf_t *sb, char c);
+
+int
+lv2lint_strbuf_vprintf(strbuf_t *sb, const char *fmt, va_list args);
+
+int
+lv2lint_strbuf_printf(strbuf_t *sb, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+
+void
+lv2lint_strbuf_reset(strbuf_t *sb);
+
+char *
+lv2lint_strbuf_steal(strbuf_t *sb);
+
+void
+lv2lint_strbuf_free(strbuf_t *sb);
+
+uint64_t
+lv2lint_fnv1a(uint64_t hash, const void *data, size_t len);
+
 int
 log_vprintf(void *data, LV2_URID type , const char *fmt, va_list args);
 
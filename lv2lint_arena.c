@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+
+#include <lv2lint.h>
+
+#define ARENA_CHUNK_SIZE 0x10000
+#define ARENA_ALIGN 8
+
+struct _arena_chunk_t {
+	arena_chunk_t *next;
+	size_t size;
+	size_t used;
+	char data [];
+};
+
+static arena_chunk_t *
+_chunk_new(size_t size)
+{
+	arena_chunk_t *chunk = malloc(sizeof(arena_chunk_t) + size);
+
+	if(!chunk)
+	{
+		return NULL;
+	}
+
+	chunk->next = NULL;
+	chunk->size = size;
+	chunk->used = 0;
+
+	return chunk;
+}
+
+void *
+lv2lint_arena_alloc(app_t *app, size_t len)
+{
+	arena_t *arena = &app->arena;
+	const size_t padded = (len + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+	arena_chunk_t *last = NULL;
+
+	// chunks are kept over resets, reuse them before allocating new ones
+	for(arena_chunk_t *chunk = arena->cur; chunk; chunk = chunk->next)
+	{
+		if(chunk->size - chunk->used >= padded)
+		{
+			void *ptr = chunk->data + chunk->used;
+
+			chunk->used += padded;
+			arena->cur = chunk;
+
+			return ptr;
+		}
+
+		last = chunk;
+	}
+
+	arena_chunk_t *chunk = _chunk_new(padded > ARENA_CHUNK_SIZE
+		? padded
+		: ARENA_CHUNK_SIZE);
+
+	if(!chunk)
+	{
+		return NULL;
+	}
+
+	if(last)
+	{
+		last->next = chunk;
+	}
+	else
+	{
+		arena->head = chunk;
+	}
+
+	chunk->used = padded;
+	arena->cur = chunk;
+
+	return chunk->data;
+}
+
+char *
+lv2lint_arena_strdup(app_t *app, const char *str)
+{
+	if(!str)
+	{
+		return NULL;
+	}
+
+	const size_t len = strlen(str) + 1;
+	char *dup = lv2lint_arena_alloc(app, len);
+
+	if(dup)
+	{
+		memcpy(dup, str, len);
+	}
+
+	return dup;
+}
+
+char *
+lv2lint_arena_vprintf(app_t *app, const char *fmt, va_list args)
+{
+	va_list args2;
+
+	va_copy(args2, args);
+	const int len = vsnprintf(NULL, 0, fmt, args2);
+	va_end(args2);
+
+	char *str = (len >= 0)
+		? lv2lint_arena_alloc(app, len + 1)
+		: NULL;
+
+	if(str)
+	{
+		vsnprintf(str, len + 1, fmt, args);
+	}
+
+	return str;
+}
+
+char *
+lv2lint_arena_printf(app_t *app, const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+
+	char *str = lv2lint_arena_vprintf(app, fmt, args);
+
+	va_end(args);
+
+	return str;
+}
+
+void
+lv2lint_arena_reset(app_t *app)
+{
+	arena_t *arena = &app->arena;
+
+	for(arena_chunk_t *chunk = arena->head; chunk; chunk = chunk->next)
+	{
+		chunk->used = 0;
+	}
+
+	arena->cur = arena->head;
+}
+
+void
+lv2lint_arena_free(app_t *app)
+{
+	arena_t *arena = &app->arena;
+
+	for(arena_chunk_t *chunk = arena->head, *next; chunk; chunk = next)
+	{
+		next = chunk->next;
+
+		free(chunk);
+	}
+
+	arena->head = NULL;
+	arena->cur = NULL;
+}
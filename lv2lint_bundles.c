@@ -0,0 +1,1206 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <lv2lint.h>
+
+#define DEFAULT_LV2_PATH "~/.lv2:/usr/lib/lv2:/usr/local/lib/lv2"
+
+typedef struct _manifest_t manifest_t;
+typedef struct _prefix_t prefix_t;
+
+struct _prefix_t {
+	char *name;
+	char *iri;
+};
+
+struct _manifest_t {
+	char *bundle;
+	char *text;
+	prefix_t *prefixes;
+	unsigned n_prefixes;
+	bool loaded;
+};
+
+static char *
+_read_file(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+
+	if(!f)
+	{
+		return NULL;
+	}
+
+	char *text = NULL;
+	size_t len = 0;
+	FILE *out = open_memstream(&text, &len);
+
+	if(out)
+	{
+		char buf [BUFSIZ];
+		size_t n;
+
+		while( (n = fread(buf, 1, sizeof(buf), f)) > 0)
+		{
+			fwrite(buf, 1, n, out);
+		}
+
+		fclose(out);
+	}
+
+	fclose(f);
+
+	return text;
+}
+
+// collect '@prefix name: <iri> .' and 'PREFIX name: <iri>' declarations
+static void
+_parse_prefixes(manifest_t *manifest)
+{
+	for(const char *ptr = manifest->text; *ptr; ptr++)
+	{
+		if(!strncmp(ptr, "@prefix", 7))
+		{
+			ptr += 7;
+		}
+		else if(!strncasecmp(ptr, "PREFIX", 6) && (ptr == manifest->text || isspace(ptr[-1])) )
+		{
+			ptr += 6;
+		}
+		else
+		{
+			continue;
+		}
+
+		while(isspace(*ptr))
+		{
+			ptr++;
+		}
+
+		const char *name = ptr;
+		const char *colon = strchr(name, ':');
+		const char *lt = colon ? strchr(colon, '<') : NULL;
+		const char *gt = lt ? strchr(lt, '>') : NULL;
+
+		if(!gt)
+		{
+			break;
+		}
+
+		prefix_t *prefixes = realloc(manifest->prefixes,
+			(manifest->n_prefixes + 1) * sizeof(prefix_t));
+		if(!prefixes)
+		{
+			break;
+		}
+
+		manifest->prefixes = prefixes;
+
+		prefix_t *prefix = &manifest->prefixes[manifest->n_prefixes++];
+		prefix->name = strndup(name, colon - name);
+		prefix->iri = strndup(lt + 1, gt - lt - 1);
+
+		ptr = gt;
+	}
+}
+
+// cheap textual check whether a manifest mentions an URI, either as full
+// IRI or as prefixed name, false positives merely load an extra bundle
+static bool
+_mentions(const manifest_t *manifest, const char *uri)
+{
+	char *iri = NULL;
+
+	if(asprintf(&iri, "<%s>", uri) != -1)
+	{
+		const bool found = strstr(manifest->text, iri) != NULL;
+
+		free(iri);
+
+		if(found)
+		{
+			return true;
+		}
+	}
+
+	for(unsigned i = 0; i < manifest->n_prefixes; i++)
+	{
+		const prefix_t *prefix = &manifest->prefixes[i];
+		const size_t len = prefix->iri ? strlen(prefix->iri) : 0;
+		char *pname = NULL;
+
+		if(!len || !prefix->name || strncmp(uri, prefix->iri, len))
+		{
+			continue;
+		}
+
+		if(asprintf(&pname, "%s:%s", prefix->name, uri + len) != -1)
+		{
+			const bool found = strstr(manifest->text, pname) != NULL;
+
+			free(pname);
+
+			if(found)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+static manifest_t *
+_scan_dir(const char *dir, manifest_t *manifests, unsigned *n_manifests)
+{
+	DIR *d = opendir(dir);
+
+	if(!d)
+	{
+		return manifests;
+	}
+
+	struct dirent *entry;
+
+	while( (entry = readdir(d)) )
+	{
+		if(entry->d_name[0] == '.')
+		{
+			continue;
+		}
+
+		char *bundle = NULL;
+		char *path = NULL;
+
+		if(asprintf(&bundle, "%s/%s/", dir, entry->d_name) == -1)
+		{
+			continue;
+		}
+
+		if(asprintf(&path, "%smanifest.ttl", bundle) == -1)
+		{
+			free(bundle);
+			continue;
+		}
+
+		char *text = _read_file(path);
+
+		free(path);
+
+		if(!text)
+		{
+			free(bundle);
+			continue;
+		}
+
+		manifest_t *tmp = realloc(manifests, (*n_manifests + 1) * sizeof(manifest_t));
+		if(!tmp)
+		{
+			free(text);
+			free(bundle);
+			continue;
+		}
+
+		manifests = tmp;
+
+		manifest_t *manifest = &manifests[(*n_manifests)++];
+		manifest->bundle = bundle;
+		manifest->text = text;
+		manifest->prefixes = NULL;
+		manifest->n_prefixes = 0;
+		manifest->loaded = false;
+
+		_parse_prefixes(manifest);
+	}
+
+	closedir(d);
+
+	return manifests;
+}
+
+static void
+_load_bundle(app_t *app, const char *bundle)
+{
+	LilvNode *bundle_node = lilv_new_file_uri(app->world, NULL, bundle);
+
+	if(bundle_node)
+	{
+		lilv_world_load_bundle(app->world, bundle_node);
+
+		lilv_node_free(bundle_node);
+	}
+}
+
+static void
+_load(app_t *app, manifest_t *manifest)
+{
+	_load_bundle(app, manifest->bundle);
+
+	manifest->loaded = true;
+}
+
+static void
+_load_matching(app_t *app, manifest_t *manifests, unsigned n_manifests,
+	const char **uris, unsigned n_uris)
+{
+	for(unsigned m = 0; m < n_manifests; m++)
+	{
+		manifest_t *manifest = &manifests[m];
+
+		for(unsigned i = 0; !manifest->loaded && (i < n_uris); i++)
+		{
+			if(_mentions(manifest, uris[i]))
+			{
+				_load(app, manifest);
+			}
+		}
+	}
+}
+
+// UIs may be shipped in separate bundles, which only mention the UI URI
+static const char **
+_collect_ui_uris(app_t *app, const char **uris, unsigned n_uris, unsigned *n_ui_uris)
+{
+	const LilvPlugins *plugins = lilv_world_get_all_plugins(app->world);
+	const char **ui_uris = NULL;
+
+	*n_ui_uris = 0;
+
+	for(unsigned i = 0; plugins && (i < n_uris); i++)
+	{
+		LilvNode *uri_node = lilv_new_uri(app->world, uris[i]);
+		const LilvPlugin *plugin = uri_node
+			? lilv_plugins_get_by_uri(plugins, uri_node)
+			: NULL;
+		LilvNodes *uis = plugin
+			? lilv_plugin_get_value(plugin, NODE(app, UI__ui))
+			: NULL;
+
+		if(uis)
+		{
+			LILV_FOREACH(nodes, itr, uis)
+			{
+				const LilvNode *ui = lilv_nodes_get(uis, itr);
+				const char **tmp = realloc(ui_uris, (*n_ui_uris + 1) * sizeof(const char *));
+
+				if(!lilv_node_is_uri(ui) || !tmp)
+				{
+					continue;
+				}
+
+				ui_uris = tmp;
+				ui_uris[(*n_ui_uris)++] = lv2lint_strdup(lilv_node_as_uri(ui));
+			}
+
+			lilv_nodes_free(uis);
+		}
+
+		if(uri_node)
+		{
+			lilv_node_free(uri_node);
+		}
+	}
+
+	return ui_uris;
+}
+
+static void
+_free_ui_uris(const char **ui_uris, unsigned n_ui_uris)
+{
+	for(unsigned i = 0; i < n_ui_uris; i++)
+	{
+		free((char *)ui_uris[i]);
+	}
+
+	free(ui_uris);
+}
+
+static void
+_manifest_load_bundles(app_t *app, char **dirs, unsigned n_dirs,
+	const char **uris, unsigned n_uris)
+{
+	manifest_t *manifests = NULL;
+	unsigned n_manifests = 0;
+
+	for(unsigned d = 0; d < n_dirs; d++)
+	{
+		manifests = _scan_dir(dirs[d], manifests, &n_manifests);
+	}
+
+	// specification bundles, needed for test items that query spec data
+	for(unsigned m = 0; m < n_manifests; m++)
+	{
+		manifest_t *manifest = &manifests[m];
+
+		if(strstr(manifest->text, "Specification"))
+		{
+			_load(app, manifest);
+		}
+	}
+
+	_load_matching(app, manifests, n_manifests, uris, n_uris);
+
+	unsigned n_ui_uris = 0;
+	const char **ui_uris = _collect_ui_uris(app, uris, n_uris, &n_ui_uris);
+
+	if(ui_uris)
+	{
+		_load_matching(app, manifests, n_manifests, ui_uris, n_ui_uris);
+		_free_ui_uris(ui_uris, n_ui_uris);
+	}
+
+	for(unsigned m = 0; m < n_manifests; m++)
+	{
+		manifest_t *manifest = &manifests[m];
+
+		for(unsigned i = 0; i < manifest->n_prefixes; i++)
+		{
+			free(manifest->prefixes[i].name);
+			free(manifest->prefixes[i].iri);
+		}
+
+		free(manifest->prefixes);
+		free(manifest->text);
+		free(manifest->bundle);
+	}
+
+	free(manifests);
+}
+
+/*
+ * Discovery index
+ *
+ * Maps plugin and UI URIs to their bundle and binary paths. Layout:
+ *   index_hdr_t | index_bundle_t[n_bundles] | index_entry_t[n_entries] | strings
+ * Bundles are sorted by path, entries by URI, strings are zero-terminated and
+ * referenced by offset into the string pool.
+ */
+
+#define INDEX_MAGIC "LV2LIDX1"
+
+typedef struct _index_hdr_t index_hdr_t;
+typedef struct _index_bundle_t index_bundle_t;
+typedef struct _index_entry_t index_entry_t;
+typedef struct _index_t index_t;
+typedef struct _builder_t builder_t;
+typedef struct _scan_t scan_t;
+
+typedef enum _index_kind_t {
+	INDEX_KIND_PLUGIN,
+	INDEX_KIND_UI
+} index_kind_t;
+
+struct _index_hdr_t {
+	char magic [8];
+	uint32_t n_bundles;
+	uint32_t n_entries;
+	uint32_t strings_len;
+	uint32_t reserved;
+};
+
+struct _index_bundle_t {
+	uint32_t path;
+	uint32_t spec;
+	int64_t mtime_sec;
+	int64_t mtime_nsec;
+};
+
+struct _index_entry_t {
+	uint32_t uri;
+	uint32_t binary;
+	uint32_t bundle;
+	uint32_t kind;
+};
+
+struct _index_t {
+	void *map;
+	size_t size;
+	const index_hdr_t *hdr;
+	const index_bundle_t *bundles;
+	const index_entry_t *entries;
+	const char *strings;
+};
+
+struct _scan_t {
+	char *path;
+	int64_t mtime_sec;
+	int64_t mtime_nsec;
+	bool spec;
+};
+
+struct _builder_t {
+	scan_t *bundles;
+	unsigned n_bundles;
+	index_entry_t *entries;
+	unsigned n_entries;
+	char *strings;
+	size_t strings_len;
+	size_t strings_max;
+};
+
+static const char *
+_index_str(const index_t *index, uint32_t off)
+{
+	return &index->strings[off];
+}
+
+static void
+_index_unmap(index_t *index)
+{
+	if(index->map)
+	{
+		munmap(index->map, index->size);
+	}
+
+	memset(index, 0x0, sizeof(index_t));
+}
+
+static int
+_index_map(index_t *index, const char *path)
+{
+	memset(index, 0x0, sizeof(index_t));
+
+	const int fd = open(path, O_RDONLY);
+	struct stat st;
+
+	if(fd == -1)
+	{
+		return -1;
+	}
+
+	if( (fstat(fd, &st) == -1) || ((size_t)st.st_size < sizeof(index_hdr_t)) )
+	{
+		close(fd);
+		return -1;
+	}
+
+	index->size = st.st_size;
+	index->map = mmap(NULL, index->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if(index->map == MAP_FAILED)
+	{
+		index->map = NULL;
+		return -1;
+	}
+
+	const index_hdr_t *hdr = index->map;
+	const size_t len = sizeof(index_hdr_t)
+		+ (size_t)hdr->n_bundles * sizeof(index_bundle_t)
+		+ (size_t)hdr->n_entries * sizeof(index_entry_t)
+		+ hdr->strings_len;
+
+	if(  memcmp(hdr->magic, INDEX_MAGIC, sizeof(hdr->magic))
+		|| (len != index->size)
+		|| (hdr->strings_len == 0) )
+	{
+		_index_unmap(index);
+		return -1;
+	}
+
+	index->hdr = hdr;
+	index->bundles = (const index_bundle_t *)&hdr[1];
+	index->entries = (const index_entry_t *)&index->bundles[hdr->n_bundles];
+	index->strings = (const char *)&index->entries[hdr->n_entries];
+
+	// validate references, a corrupt index must not make us read out of bounds
+	bool valid = index->strings[hdr->strings_len - 1] == '\0';
+
+	for(uint32_t i = 0; valid && (i < hdr->n_bundles); i++)
+	{
+		valid = index->bundles[i].path < hdr->strings_len;
+	}
+
+	for(uint32_t i = 0; valid && (i < hdr->n_entries); i++)
+	{
+		const index_entry_t *entry = &index->entries[i];
+
+		valid = (entry->uri < hdr->strings_len)
+			&& (entry->binary < hdr->strings_len)
+			&& (entry->bundle < hdr->n_bundles);
+	}
+
+	if(!valid)
+	{
+		_index_unmap(index);
+		return -1;
+	}
+
+	return 0;
+}
+
+// first entry with given URI or n_entries
+static uint32_t
+_index_lower_bound(const index_t *index, const char *uri)
+{
+	uint32_t lo = 0;
+	uint32_t hi = index->hdr->n_entries;
+
+	while(lo < hi)
+	{
+		const uint32_t mid = lo + (hi - lo) / 2;
+
+		if(strcmp(_index_str(index, index->entries[mid].uri), uri) < 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static int32_t
+_index_find_bundle(const index_t *index, const char *path)
+{
+	int32_t lo = 0;
+	int32_t hi = (int32_t)index->hdr->n_bundles - 1;
+
+	while(lo <= hi)
+	{
+		const int32_t mid = lo + (hi - lo) / 2;
+		const int cmp = strcmp(_index_str(index, index->bundles[mid].path), path);
+
+		if(cmp == 0)
+		{
+			return mid;
+		}
+		else if(cmp < 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid - 1;
+		}
+	}
+
+	return -1;
+}
+
+static uint32_t
+_builder_str(builder_t *builder, const char *str)
+{
+	const size_t len = strlen(str) + 1;
+
+	if(builder->strings_len + len > builder->strings_max)
+	{
+		size_t max = builder->strings_max ? builder->strings_max : 4096;
+
+		while(builder->strings_len + len > max)
+		{
+			max <<= 1;
+		}
+
+		char *strings = realloc(builder->strings, max);
+		if(!strings)
+		{
+			return 0; // offset 0 is the empty string
+		}
+
+		builder->strings = strings;
+		builder->strings_max = max;
+	}
+
+	const uint32_t off = builder->strings_len;
+
+	memcpy(&builder->strings[off], str, len);
+	builder->strings_len += len;
+
+	return off;
+}
+
+static void
+_builder_entry(builder_t *builder, const char *uri, const char *binary,
+	uint32_t bundle, index_kind_t kind)
+{
+	index_entry_t *entries = realloc(builder->entries,
+		(builder->n_entries + 1) * sizeof(index_entry_t));
+	if(!entries)
+	{
+		return;
+	}
+
+	builder->entries = entries;
+
+	index_entry_t *entry = &builder->entries[builder->n_entries++];
+	entry->uri = _builder_str(builder, uri);
+	entry->binary = _builder_str(builder, binary ? binary : "");
+	entry->bundle = bundle;
+	entry->kind = kind;
+}
+
+static void
+_builder_binary(builder_t *builder, const LilvNode *uri, const LilvNode *binary,
+	uint32_t bundle, index_kind_t kind)
+{
+	char *path = binary && lilv_node_is_uri(binary)
+		? lilv_file_uri_parse(lilv_node_as_uri(binary), NULL)
+		: NULL;
+
+	_builder_entry(builder, lilv_node_as_uri(uri), path, bundle, kind);
+
+	if(path)
+	{
+		lilv_free(path);
+	}
+}
+
+// parse a single changed bundle in a throw-away world
+static void
+_builder_extract(builder_t *builder, uint32_t bundle)
+{
+	static const char *ui_classes [] = {
+		LV2_UI__X11UI,
+		LV2_UI__GtkUI,
+		LV2_UI__Gtk3UI,
+		LV2_UI__Qt4UI,
+		LV2_UI__Qt5UI,
+		LV2_UI__CocoaUI,
+		LV2_UI__WindowsUI,
+		LV2_EXTERNAL_UI__Widget,
+		LV2_EXTERNAL_UI_DEPRECATED_URI
+	};
+	static const unsigned n_ui_classes = sizeof(ui_classes) / sizeof(const char *);
+
+	LilvWorld *world = lilv_world_new();
+	if(!world)
+	{
+		return;
+	}
+
+	LilvNode *bundle_node = lilv_new_file_uri(world, NULL, builder->bundles[bundle].path);
+	LilvNode *rdf_type = lilv_new_uri(world, LILV_NS_RDF"type");
+	LilvNode *ui_binary = lilv_new_uri(world, LV2_UI__binary);
+
+	if(bundle_node && rdf_type && ui_binary)
+	{
+		lilv_world_load_bundle(world, bundle_node);
+
+		const LilvPlugins *plugins = lilv_world_get_all_plugins(world);
+
+		LILV_FOREACH(plugins, itr, plugins)
+		{
+			const LilvPlugin *plugin = lilv_plugins_get(plugins, itr);
+
+			_builder_binary(builder, lilv_plugin_get_uri(plugin),
+				lilv_plugin_get_library_uri(plugin), bundle, INDEX_KIND_PLUGIN);
+		}
+
+		for(unsigned c = 0; c < n_ui_classes; c++)
+		{
+			LilvNode *ui_class = lilv_new_uri(world, ui_classes[c]);
+			LilvNodes *uis = ui_class
+				? lilv_world_find_nodes(world, NULL, rdf_type, ui_class)
+				: NULL;
+
+			if(uis)
+			{
+				LILV_FOREACH(nodes, itr, uis)
+				{
+					const LilvNode *ui = lilv_nodes_get(uis, itr);
+					LilvNode *binary = lilv_node_is_uri(ui)
+						? lilv_world_get(world, ui, ui_binary, NULL)
+						: NULL;
+
+					if(lilv_node_is_uri(ui))
+					{
+						_builder_binary(builder, ui, binary, bundle, INDEX_KIND_UI);
+					}
+
+					if(binary)
+					{
+						lilv_node_free(binary);
+					}
+				}
+
+				lilv_nodes_free(uis);
+			}
+
+			if(ui_class)
+			{
+				lilv_node_free(ui_class);
+			}
+		}
+	}
+
+	if(ui_binary)
+	{
+		lilv_node_free(ui_binary);
+	}
+
+	if(rdf_type)
+	{
+		lilv_node_free(rdf_type);
+	}
+
+	if(bundle_node)
+	{
+		lilv_node_free(bundle_node);
+	}
+
+	lilv_world_free(world);
+}
+
+static void
+_builder_scan_dir(builder_t *builder, const char *dir)
+{
+	DIR *d = opendir(dir);
+
+	if(!d)
+	{
+		return;
+	}
+
+	struct dirent *entry;
+
+	while( (entry = readdir(d)) )
+	{
+		char *bundle = NULL;
+		char *path = NULL;
+		struct stat st;
+
+		if(entry->d_name[0] == '.')
+		{
+			continue;
+		}
+
+		if(asprintf(&bundle, "%s/%s/", dir, entry->d_name) == -1)
+		{
+			continue;
+		}
+
+		if(asprintf(&path, "%smanifest.ttl", bundle) == -1)
+		{
+			free(bundle);
+			continue;
+		}
+
+		scan_t *bundles = (stat(path, &st) == 0)
+			? realloc(builder->bundles, (builder->n_bundles + 1) * sizeof(scan_t))
+			: NULL;
+
+		free(path);
+
+		if(!bundles)
+		{
+			free(bundle);
+			continue;
+		}
+
+		builder->bundles = bundles;
+
+		scan_t *scan = &builder->bundles[builder->n_bundles++];
+		scan->path = bundle;
+		scan->mtime_sec = st.st_mtim.tv_sec;
+		scan->mtime_nsec = st.st_mtim.tv_nsec;
+		scan->spec = false;
+	}
+
+	closedir(d);
+}
+
+static int
+_scan_cmp(const void *a, const void *b)
+{
+	const scan_t *scan_a = a;
+	const scan_t *scan_b = b;
+
+	return strcmp(scan_a->path, scan_b->path);
+}
+
+static int
+_entry_cmp(const void *a, const void *b, void *data)
+{
+	const builder_t *builder = data;
+	const index_entry_t *entry_a = a;
+	const index_entry_t *entry_b = b;
+
+	const int cmp = strcmp(&builder->strings[entry_a->uri],
+		&builder->strings[entry_b->uri]);
+
+	if(cmp)
+	{
+		return cmp;
+	}
+
+	// deterministic order for URIs installed in multiple bundles
+	return (int)entry_a->bundle - (int)entry_b->bundle;
+}
+
+static int
+_builder_write(builder_t *builder, const char *path)
+{
+	index_bundle_t *bundles = calloc(builder->n_bundles + 1, sizeof(index_bundle_t));
+	char *tmp_path = NULL;
+
+	if(!bundles || (asprintf(&tmp_path, "%s.XXXXXX", path) == -1) )
+	{
+		free(bundles);
+		return -1;
+	}
+
+	for(unsigned i = 0; i < builder->n_bundles; i++)
+	{
+		const scan_t *scan = &builder->bundles[i];
+		index_bundle_t *bundle = &bundles[i];
+
+		bundle->path = _builder_str(builder, scan->path);
+		bundle->spec = scan->spec;
+		bundle->mtime_sec = scan->mtime_sec;
+		bundle->mtime_nsec = scan->mtime_nsec;
+	}
+
+	qsort_r(builder->entries, builder->n_entries, sizeof(index_entry_t), _entry_cmp,
+		builder);
+
+	index_hdr_t hdr = {
+		.n_bundles = builder->n_bundles,
+		.n_entries = builder->n_entries,
+		.strings_len = builder->strings_len
+	};
+	memcpy(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic));
+
+	const int fd = mkstemp(tmp_path);
+	FILE *f = (fd != -1)
+		? fdopen(fd, "wb")
+		: NULL;
+
+	if(!f)
+	{
+		if(fd != -1)
+		{
+			close(fd);
+			unlink(tmp_path);
+		}
+
+		free(tmp_path);
+		free(bundles);
+		return -1;
+	}
+
+	bool failed = (fwrite(&hdr, sizeof(hdr), 1, f) != 1)
+		|| (builder->n_bundles
+			&& (fwrite(bundles, sizeof(index_bundle_t), builder->n_bundles, f) != builder->n_bundles) )
+		|| (builder->n_entries
+			&& (fwrite(builder->entries, sizeof(index_entry_t), builder->n_entries, f) != builder->n_entries) )
+		|| (fwrite(builder->strings, builder->strings_len, 1, f) != 1);
+
+	failed = (fclose(f) != 0) || failed;
+
+	if(failed || (rename(tmp_path, path) == -1) )
+	{
+		unlink(tmp_path);
+		failed = true;
+	}
+
+	free(tmp_path);
+	free(bundles);
+
+	return failed ? -1 : 0;
+}
+
+static void
+_builder_free(builder_t *builder)
+{
+	for(unsigned i = 0; i < builder->n_bundles; i++)
+	{
+		free(builder->bundles[i].path);
+	}
+
+	free(builder->bundles);
+	free(builder->entries);
+	free(builder->strings);
+}
+
+// bring index up to date with bundles on LV2_PATH, only re-parse changed ones
+static int
+_index_update(index_t *index, const char *path, char **dirs, unsigned n_dirs)
+{
+	builder_t builder;
+	memset(&builder, 0x0, sizeof(builder_t));
+
+	_builder_str(&builder, ""); // offset 0
+
+	for(unsigned d = 0; d < n_dirs; d++)
+	{
+		_builder_scan_dir(&builder, dirs[d]);
+	}
+
+	qsort(builder.bundles, builder.n_bundles, sizeof(scan_t), _scan_cmp);
+
+	const bool has_index = _index_map(index, path) == 0;
+	uint32_t *new_of_old = has_index
+		? malloc((index->hdr->n_bundles + 1) * sizeof(uint32_t))
+		: NULL;
+	bool changed = !has_index
+		|| (index->hdr->n_bundles != builder.n_bundles);
+
+	if(new_of_old)
+	{
+		for(uint32_t i = 0; i < index->hdr->n_bundles; i++)
+		{
+			new_of_old[i] = UINT32_MAX;
+		}
+	}
+
+	for(unsigned i = 0; i < builder.n_bundles; i++)
+	{
+		scan_t *scan = &builder.bundles[i];
+		const int32_t old = new_of_old
+			? _index_find_bundle(index, scan->path)
+			: -1;
+
+		if(  (old != -1)
+			&& (index->bundles[old].mtime_sec == scan->mtime_sec)
+			&& (index->bundles[old].mtime_nsec == scan->mtime_nsec) )
+		{
+			new_of_old[old] = i;
+			scan->spec = index->bundles[old].spec;
+		}
+		else
+		{
+			char *manifest_path = NULL;
+
+			if(asprintf(&manifest_path, "%smanifest.ttl", scan->path) != -1)
+			{
+				char *text = _read_file(manifest_path);
+
+				scan->spec = text && strstr(text, "Specification");
+
+				free(text);
+				free(manifest_path);
+			}
+
+			_builder_extract(&builder, i);
+			changed = true;
+		}
+	}
+
+	if(!changed)
+	{
+		free(new_of_old);
+		_builder_free(&builder);
+
+		return 0;
+	}
+
+	if(new_of_old)
+	{
+		for(uint32_t i = 0; i < index->hdr->n_entries; i++)
+		{
+			const index_entry_t *entry = &index->entries[i];
+			const uint32_t bundle = new_of_old[entry->bundle];
+
+			if(bundle != UINT32_MAX)
+			{
+				_builder_entry(&builder, _index_str(index, entry->uri),
+					_index_str(index, entry->binary), bundle, entry->kind);
+			}
+		}
+	}
+
+	free(new_of_old);
+	_index_unmap(index);
+
+	const int ret = _builder_write(&builder, path);
+
+	_builder_free(&builder);
+
+	if(ret == -1)
+	{
+		return -1;
+	}
+
+	return _index_map(index, path);
+}
+
+static void
+_index_load_uris(app_t *app, const index_t *index, bool *loaded,
+	const char **uris, unsigned n_uris)
+{
+	for(unsigned i = 0; i < n_uris; i++)
+	{
+		for(uint32_t e = _index_lower_bound(index, uris[i]);
+			(e < index->hdr->n_entries)
+				&& !strcmp(_index_str(index, index->entries[e].uri), uris[i]);
+			e++)
+		{
+			const uint32_t bundle = index->entries[e].bundle;
+
+			if(!loaded[bundle])
+			{
+				_load_bundle(app, _index_str(index, index->bundles[bundle].path));
+				loaded[bundle] = true;
+			}
+		}
+	}
+}
+
+static int
+_index_load_bundles(app_t *app, char **dirs, unsigned n_dirs,
+	const char **uris, unsigned n_uris)
+{
+	char *cache_dir = lv2lint_cache_dir_new();
+	char *path = NULL;
+	index_t index;
+	uint64_t hash = LV2LINT_FNV1A_INIT;
+
+	if(!cache_dir)
+	{
+		return -1;
+	}
+
+	// separate index per LV2_PATH
+	for(unsigned d = 0; d < n_dirs; d++)
+	{
+		hash = lv2lint_fnv1a(hash, dirs[d], strlen(dirs[d]) + 1);
+	}
+
+	const int len = asprintf(&path, "%s/index-%016"PRIx64, cache_dir, hash);
+
+	free(cache_dir);
+
+	if(len == -1)
+	{
+		return -1;
+	}
+
+	if(_index_update(&index, path, dirs, n_dirs) == -1)
+	{
+		free(path);
+		return -1;
+	}
+
+	free(path);
+
+	bool *loaded = calloc(index.hdr->n_bundles + 1, sizeof(bool));
+	if(!loaded)
+	{
+		_index_unmap(&index);
+		return -1;
+	}
+
+	// specification bundles, needed for test items that query spec data
+	for(uint32_t b = 0; b < index.hdr->n_bundles; b++)
+	{
+		if(index.bundles[b].spec)
+		{
+			_load_bundle(app, _index_str(&index, index.bundles[b].path));
+			loaded[b] = true;
+		}
+	}
+
+	_index_load_uris(app, &index, loaded, uris, n_uris);
+
+	unsigned n_ui_uris = 0;
+	const char **ui_uris = _collect_ui_uris(app, uris, n_uris, &n_ui_uris);
+
+	if(ui_uris)
+	{
+		_index_load_uris(app, &index, loaded, ui_uris, n_ui_uris);
+		_free_ui_uris(ui_uris, n_ui_uris);
+	}
+
+	free(loaded);
+	_index_unmap(&index);
+
+	return 0;
+}
+
+static char **
+_lv2_path_dirs(unsigned *n_dirs)
+{
+	const char *env_path = getenv("LV2_PATH");
+	char *lv2_path = lv2lint_strdup(env_path ? env_path : DEFAULT_LV2_PATH);
+	const char *home = getenv("HOME");
+	char **dirs = NULL;
+
+	*n_dirs = 0;
+
+	if(!lv2_path)
+	{
+		return NULL;
+	}
+
+	for(char *bufp = lv2_path, *dir = strsep(&bufp, ":");
+		dir;
+		dir = strsep(&bufp, ":") )
+	{
+		char *abs_dir = NULL;
+
+		if( (dir[0] == '~') && home)
+		{
+			if(asprintf(&abs_dir, "%s%s", home, dir + 1) == -1)
+			{
+				abs_dir = NULL;
+			}
+		}
+		else if(dir[0] != '\0')
+		{
+			abs_dir = lv2lint_strdup(dir);
+		}
+
+		char **tmp = abs_dir
+			? realloc(dirs, (*n_dirs + 1) * sizeof(char *))
+			: NULL;
+
+		if(!tmp)
+		{
+			free(abs_dir);
+			continue;
+		}
+
+		dirs = tmp;
+		dirs[(*n_dirs)++] = abs_dir;
+	}
+
+	free(lv2_path);
+
+	return dirs;
+}
+
+void
+lv2lint_load_bundles(app_t *app, const char **uris, unsigned n_uris)
+{
+	unsigned n_dirs = 0;
+	char **dirs = _lv2_path_dirs(&n_dirs);
+
+	// fall back to scanning manifests if the index is not available
+	if(_index_load_bundles(app, dirs, n_dirs, uris, n_uris) == -1)
+	{
+		_manifest_load_bundles(app, dirs, n_dirs, uris, n_uris);
+	}
+
+	for(unsigned d = 0; d < n_dirs; d++)
+	{
+		free(dirs[d]);
+	}
+
+	free(dirs);
+}
@@ -0,0 +1,754 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <lv2lint.h>
+
+#define CACHE_MAGIC "LV2LINT1"
+
+typedef struct _entry_hdr_t entry_hdr_t;
+typedef struct _stamp_t stamp_t;
+
+struct _entry_hdr_t {
+	char magic [8];
+	uint64_t meta;
+	uint64_t data;
+	int32_t ret;
+	uint32_t key_len;
+	uint64_t out_len;
+};
+
+struct _stamp_t {
+	uint64_t meta;
+	uint64_t data;
+	bool has_data;
+};
+
+static int
+_mkdir_p(const char *path)
+{
+	char *dir = lv2lint_strdup(path);
+
+	if(!dir)
+	{
+		return -1;
+	}
+
+	for(char *ptr = strchr(dir + 1, '/'); ptr; ptr = strchr(ptr + 1, '/'))
+	{
+		*ptr = '\0';
+
+		if( (mkdir(dir, 0755) == -1) && (errno != EEXIST) )
+		{
+			free(dir);
+			return -1;
+		}
+
+		*ptr = '/';
+	}
+
+	const int ret = ( (mkdir(dir, 0755) == -1) && (errno != EEXIST) )
+		? -1
+		: 0;
+
+	free(dir);
+
+	return ret;
+}
+
+static uint64_t
+_hash_str(uint64_t hash, const char *str)
+{
+	if(!str)
+	{
+		str = "";
+	}
+
+	// include terminating zero to separate consecutive strings
+	return lv2lint_fnv1a(hash, str, strlen(str) + 1);
+}
+
+static uint64_t
+_hash_file(uint64_t hash, const char *path)
+{
+	const int fd = open(path, O_RDONLY);
+
+	if(fd == -1)
+	{
+		return hash;
+	}
+
+	uint8_t buf [BUFSIZ];
+	ssize_t len;
+
+	while( (len = read(fd, buf, sizeof(buf))) > 0)
+	{
+		hash = lv2lint_fnv1a(hash, buf, len);
+	}
+
+	close(fd);
+
+	return hash;
+}
+
+static void
+_stamp_file(stamp_t *stamp, const char *path, const char *name, bool data)
+{
+	struct stat st;
+
+	if( (stat(path, &st) == -1) || !S_ISREG(st.st_mode) )
+	{
+		return;
+	}
+
+	const int64_t meta [3] = {
+		st.st_size,
+		st.st_mtim.tv_sec,
+		st.st_mtim.tv_nsec
+	};
+
+	if(data)
+	{
+		stamp->data = _hash_str(stamp->data, name);
+		stamp->data = _hash_file(stamp->data, path);
+	}
+	else
+	{
+		stamp->meta = _hash_str(stamp->meta, name);
+		stamp->meta = lv2lint_fnv1a(stamp->meta, meta, sizeof(meta));
+	}
+}
+
+static void
+_stamp_dir(stamp_t *stamp, const char *path, const char *prefix, bool data)
+{
+	struct dirent **entries = NULL;
+
+	// sort entries, readdir order is not stable across file systems
+	const int n = scandir(path, &entries, NULL, alphasort);
+
+	for(int i = 0; i < n; i++)
+	{
+		const char *name = entries[i]->d_name;
+		char *sub_path = NULL;
+		char *sub_prefix = NULL;
+		struct stat st;
+
+		if(!strcmp(name, ".") || !strcmp(name, ".."))
+		{
+			free(entries[i]);
+			continue;
+		}
+
+		if(  (asprintf(&sub_path, "%s/%s", path, name) != -1)
+			&& (asprintf(&sub_prefix, "%s%s", prefix, name) != -1)
+			&& (lstat(sub_path, &st) == 0) )
+		{
+			if(S_ISDIR(st.st_mode)) // do not follow symlinked directories
+			{
+				char *dir_prefix = NULL;
+
+				if(asprintf(&dir_prefix, "%s/", sub_prefix) != -1)
+				{
+					_stamp_dir(stamp, sub_path, dir_prefix, data);
+					free(dir_prefix);
+				}
+			}
+			else
+			{
+				_stamp_file(stamp, sub_path, sub_prefix, data);
+			}
+		}
+
+		free(sub_path);
+		free(sub_prefix);
+		free(entries[i]);
+	}
+
+	free(entries);
+}
+
+typedef struct _bundles_t bundles_t;
+
+// bundle directories already stamped, plugin data may be spread over many
+struct _bundles_t {
+	unsigned n;
+	char **paths;
+};
+
+static void
+_stamp_bundle(stamp_t *stamp, bundles_t *bundles, const char *uri, bool is_file,
+	bool data)
+{
+	char *path = uri
+		? lilv_file_uri_parse(uri, NULL)
+		: NULL;
+
+	if(!path)
+	{
+		return;
+	}
+
+	// strip file name of data files and trailing slashes of bundles
+	char *slash = strrchr(path, '/');
+
+	if(is_file && slash)
+	{
+		*slash = '\0';
+	}
+
+	for(size_t len = strlen(path); (len > 1) && (path[len - 1] == '/'); len--)
+	{
+		path[len - 1] = '\0';
+	}
+
+	for(unsigned i = 0; i < bundles->n; i++)
+	{
+		if(!strcmp(bundles->paths[i], path))
+		{
+			lilv_free(path);
+			return;
+		}
+	}
+
+	// plugin bundle is stamped first and relative, all others absolute
+	const bool is_first = (bundles->n == 0);
+	char **paths = realloc(bundles->paths, (bundles->n + 1) * sizeof(char *));
+	char *dup = lv2lint_strdup(path);
+	char *prefix = NULL;
+
+	if(paths)
+	{
+		bundles->paths = paths;
+	}
+
+	if(paths && dup)
+	{
+		bundles->paths[bundles->n++] = dup;
+	}
+	else
+	{
+		free(dup);
+	}
+
+	if(asprintf(&prefix, "%s/", is_first ? "" : path) != -1)
+	{
+		_stamp_dir(stamp, path, is_first ? "" : prefix, data);
+		free(prefix);
+	}
+
+	lilv_free(path);
+}
+
+static void
+_stamp_binary(stamp_t *stamp, const bundles_t *bundles, const LilvNode *node,
+	bool data)
+{
+	char *path = node && lilv_node_is_uri(node)
+		? lilv_file_uri_parse(lilv_node_as_uri(node), NULL)
+		: NULL;
+
+	if(!path)
+	{
+		return;
+	}
+
+	// binary may live outside of the bundles
+	for(unsigned i = 0; i < bundles->n; i++)
+	{
+		const size_t len = strlen(bundles->paths[i]);
+
+		if(!strncmp(path, bundles->paths[i], len)
+			&& (path[len] == '/') )
+		{
+			lilv_free(path);
+			return;
+		}
+	}
+
+	_stamp_file(stamp, path, path, data);
+
+	lilv_free(path);
+}
+
+static void
+_stamp_plugin(app_t *app, const LilvPlugin *plugin, stamp_t *stamp, bool data)
+{
+	bundles_t bundles = { .n = 0 };
+
+	if(data)
+	{
+		stamp->data = LV2LINT_FNV1A_INIT;
+	}
+	else
+	{
+		stamp->meta = LV2LINT_FNV1A_INIT;
+	}
+
+	_stamp_bundle(stamp, &bundles,
+		lilv_node_as_uri(lilv_plugin_get_bundle_uri(plugin)), false, data);
+
+	// e.g. extension bundles adding data about the plugin
+	const LilvNodes *data_uris = lilv_plugin_get_data_uris(plugin);
+	if(data_uris)
+	{
+		LILV_FOREACH(nodes, itr, data_uris)
+		{
+			const LilvNode *node = lilv_nodes_get(data_uris, itr);
+
+			_stamp_bundle(stamp, &bundles, lilv_node_as_uri(node), true, data);
+		}
+	}
+
+	// separately shipped UI bundles
+	LilvUIs *uis = lilv_plugin_get_uis(plugin);
+	if(uis)
+	{
+		LILV_FOREACH(uis, itr, uis)
+		{
+			const LilvUI *ui = lilv_uis_get(uis, itr);
+
+			_stamp_bundle(stamp, &bundles,
+				lilv_node_as_uri(lilv_ui_get_bundle_uri(ui)), false, data);
+		}
+	}
+
+	// separately shipped preset bundles
+	LilvNodes *presets = lilv_plugin_get_related(plugin,
+		NODE(app, PRESETS__Preset));
+	LilvNode *see_also = lilv_new_uri(app->world, LILV_NS_RDFS"seeAlso");
+	if(presets && see_also)
+	{
+		LILV_FOREACH(nodes, itr, presets)
+		{
+			const LilvNode *preset = lilv_nodes_get(presets, itr);
+			LilvNodes *files = lilv_world_find_nodes(app->world,
+				preset, see_also, NULL);
+
+			if(!files)
+			{
+				continue;
+			}
+
+			LILV_FOREACH(nodes, jtr, files)
+			{
+				const LilvNode *file = lilv_nodes_get(files, jtr);
+
+				if(lilv_node_is_uri(file))
+				{
+					_stamp_bundle(stamp, &bundles, lilv_node_as_uri(file), true, data);
+				}
+			}
+
+			lilv_nodes_free(files);
+		}
+	}
+
+	_stamp_binary(stamp, &bundles, lilv_plugin_get_library_uri(plugin), data);
+
+	if(uis)
+	{
+		LILV_FOREACH(uis, itr, uis)
+		{
+			const LilvUI *ui = lilv_uis_get(uis, itr);
+
+			_stamp_binary(stamp, &bundles, lilv_ui_get_binary_uri(ui), data);
+		}
+
+		lilv_uis_free(uis);
+	}
+
+	if(see_also)
+	{
+		lilv_node_free(see_also);
+	}
+
+	if(presets)
+	{
+		lilv_nodes_free(presets);
+	}
+
+	if(data)
+	{
+		stamp->has_data = true;
+	}
+
+	for(unsigned i = 0; i < bundles.n; i++)
+	{
+		free(bundles.paths[i]);
+	}
+
+	free(bundles.paths);
+}
+
+static void
+_key_white(FILE *key, const char *label, const white_t *white)
+{
+	for( ; white; white = white->next)
+	{
+		fprintf(key, "%s %s %s\n", label,
+			white->uri ? white->uri : "*", white->pattern);
+	}
+}
+
+static char *
+_key_new(app_t *app, const char *uri)
+{
+	char *buf = NULL;
+	size_t len = 0;
+	FILE *key = open_memstream(&buf, &len);
+
+	if(!key)
+	{
+		return NULL;
+	}
+
+	fprintf(key, "version %s\n", LV2LINT_VERSION);
+#ifdef ENABLE_ELF_TESTS
+	fprintf(key, "elf-tests\n");
+#endif
+#ifdef ENABLE_X11_TESTS
+	fprintf(key, "x11-tests\n");
+#endif
+	fprintf(key, "uri %s\n", uri);
+	fprintf(key, "show %u\n", app->show);
+	fprintf(key, "mask %u\n", app->mask);
+	fprintf(key, "pck %i\n", app->pck);
+	fprintf(key, "debug %i\n", app->debug);
+	fprintf(key, "atty %i\n", app->atty);
+	fprintf(key, "format %u\n", app->format);
+	fprintf(key, "fail-fast %i\n", app->fail_fast);
+	fprintf(key, "lv2-path %s\n", getenv("LV2_PATH") ? getenv("LV2_PATH") : "");
+	for(unsigned i = 0; i < app->n_include_dirs; i++)
+	{
+		fprintf(key, "include-dir %s\n", app->include_dirs[i]);
+	}
+#ifdef ENABLE_ONLINE_TESTS
+	fprintf(key, "mailto %i\n", app->mailto);
+	fprintf(key, "greet %s\n", app->greet ? app->greet : "");
+#endif
+	_key_white(key, "test", app->whitelist_tests);
+	_key_white(key, "select", app->select_tests);
+	_key_white(key, "exclude", app->exclude_tests);
+#ifdef ENABLE_ELF_TESTS
+	_key_white(key, "symbol", app->whitelist_symbols);
+	_key_white(key, "lib", app->whitelist_libs);
+	_key_white(key, "rt", app->blacklist_rt);
+	fprintf(key, "isa-baseline %u\n", app->isa_baseline);
+#endif
+
+	fclose(key);
+
+	return buf;
+}
+
+static char *
+_entry_path(app_t *app, const char *key)
+{
+	char *path = NULL;
+	const uint64_t hash = lv2lint_fnv1a(LV2LINT_FNV1A_INIT, key, strlen(key));
+
+	if(asprintf(&path, "%s/%016"PRIx64".cache", app->cache_dir, hash) == -1)
+	{
+		return NULL;
+	}
+
+	return path;
+}
+
+static int
+_entry_store(const char *path, const char *key,
+	const stamp_t *stamp, int ret, const char *out, size_t out_len)
+{
+	char *tmp_path = NULL;
+
+	if(asprintf(&tmp_path, "%s.XXXXXX", path) == -1)
+	{
+		return -1;
+	}
+
+	const int fd = mkstemp(tmp_path);
+	FILE *f = (fd != -1)
+		? fdopen(fd, "wb")
+		: NULL;
+
+	if(!f)
+	{
+		if(fd != -1)
+		{
+			close(fd);
+			unlink(tmp_path);
+		}
+
+		free(tmp_path);
+		return -1;
+	}
+
+	entry_hdr_t hdr = {
+		.meta = stamp->meta,
+		.data = stamp->data,
+		.ret = ret,
+		.key_len = strlen(key),
+		.out_len = out_len
+	};
+	memcpy(hdr.magic, CACHE_MAGIC, sizeof(hdr.magic));
+
+	bool failed = (fwrite(&hdr, sizeof(hdr), 1, f) != 1)
+		|| (fwrite(key, hdr.key_len, 1, f) != 1)
+		|| (out_len && (fwrite(out, out_len, 1, f) != 1));
+
+	failed = (fclose(f) != 0) || failed;
+
+	// atomic replace, concurrent workers only ever see complete entries
+	if(failed || (rename(tmp_path, path) == -1) )
+	{
+		unlink(tmp_path);
+		free(tmp_path);
+		return -1;
+	}
+
+	free(tmp_path);
+
+	return 0;
+}
+
+static bool
+_entry_load(const char *path, const char *key, entry_hdr_t *hdr, char **out)
+{
+	FILE *f = fopen(path, "rb");
+
+	*out = NULL;
+
+	if(!f)
+	{
+		return false;
+	}
+
+	const size_t key_len = strlen(key);
+	char *buf = NULL;
+	bool valid = (fread(hdr, sizeof(*hdr), 1, f) == 1)
+		&& !memcmp(hdr->magic, CACHE_MAGIC, sizeof(hdr->magic))
+		&& (hdr->key_len == key_len);
+
+	// verify full key to rule out hash collisions
+	if(valid)
+	{
+		buf = malloc(key_len + 1);
+		valid = buf
+			&& (fread(buf, key_len, 1, f) == 1)
+			&& !memcmp(buf, key, key_len);
+		free(buf);
+		buf = NULL;
+	}
+
+	if(valid)
+	{
+		buf = malloc(hdr->out_len + 1);
+		valid = buf
+			&& (!hdr->out_len || (fread(buf, hdr->out_len, 1, f) == 1) );
+	}
+
+	fclose(f);
+
+	if(!valid)
+	{
+		free(buf);
+		return false;
+	}
+
+	*out = buf;
+
+	return true;
+}
+
+char *
+lv2lint_cache_dir_new(void)
+{
+	const char *xdg_cache_home = getenv("XDG_CACHE_HOME");
+	const char *home = getenv("HOME");
+	char *cache_dir = NULL;
+	int len;
+
+	if(xdg_cache_home && (xdg_cache_home[0] == '/') )
+	{
+		len = asprintf(&cache_dir, "%s/lv2lint", xdg_cache_home);
+	}
+	else if(home)
+	{
+		len = asprintf(&cache_dir, "%s/.cache/lv2lint", home);
+	}
+	else
+	{
+		return NULL;
+	}
+
+	if(len == -1)
+	{
+		return NULL;
+	}
+
+	if(_mkdir_p(cache_dir) == -1)
+	{
+		fprintf(stderr, "Failed to create cache directory `%s'.\n", cache_dir);
+
+		free(cache_dir);
+		return NULL;
+	}
+
+	return cache_dir;
+}
+
+int
+lv2lint_cache_init(app_t *app)
+{
+	app->cache_dir = lv2lint_cache_dir_new();
+
+	return app->cache_dir ? 0 : -1;
+}
+
+void
+lv2lint_cache_deinit(app_t *app)
+{
+	free(app->cache_dir);
+	app->cache_dir = NULL;
+}
+
+int
+lv2lint_cache_run(app_t *app, const LilvPlugins *plugins, const char *uri,
+	lv2lint_run_t run)
+{
+	if(app->timings) // cached reports carry no timings
+	{
+		return run(app, plugins, uri);
+	}
+
+#ifdef ENABLE_ONLINE_TESTS
+	if(app->online) // results of online tests may change at any time
+	{
+		return run(app, plugins, uri);
+	}
+#endif
+
+	LilvNode *uri_node = lilv_new_uri(app->world, uri);
+	const LilvPlugin *plugin = uri_node
+		? lilv_plugins_get_by_uri(plugins, uri_node)
+		: NULL;
+	char *key = plugin
+		? _key_new(app, uri)
+		: NULL;
+	char *path = key
+		? _entry_path(app, key)
+		: NULL;
+
+	if(uri_node)
+	{
+		lilv_node_free(uri_node);
+	}
+
+	if(!path)
+	{
+		free(key);
+
+		return run(app, plugins, uri);
+	}
+
+	stamp_t stamp = {
+		.has_data = false
+	};
+	entry_hdr_t hdr;
+	char *out = NULL;
+	int ret;
+
+	_stamp_plugin(app, plugin, &stamp, false);
+
+	if(_entry_load(path, key, &hdr, &out))
+	{
+		bool hit = (hdr.meta == stamp.meta);
+
+		if(!hit) // e.g. touched or re-installed, but unchanged content
+		{
+			_stamp_plugin(app, plugin, &stamp, true);
+
+			if(hdr.data == stamp.data)
+			{
+				hit = true;
+
+				_entry_store(path, key, &stamp, hdr.ret, out, hdr.out_len);
+			}
+		}
+
+		if(hit)
+		{
+			fwrite(out, 1, hdr.out_len, app->out);
+			ret = hdr.ret;
+
+			free(out);
+			free(path);
+			free(key);
+
+			return ret;
+		}
+
+		free(out);
+	}
+
+	// miss, capture report to be able to store it
+	FILE *orig = app->out;
+	size_t out_len = 0;
+
+	app->out = open_memstream(&out, &out_len);
+	if(!app->out)
+	{
+		app->out = orig;
+
+		free(path);
+		free(key);
+
+		return run(app, plugins, uri);
+	}
+
+	app->no_cache = false;
+	ret = run(app, plugins, uri);
+
+	fclose(app->out);
+	app->out = orig;
+
+	fwrite(out, 1, out_len, app->out);
+
+	if(!app->no_cache)
+	{
+		if(!stamp.has_data)
+		{
+			_stamp_plugin(app, plugin, &stamp, true);
+		}
+
+		_entry_store(path, key, &stamp, ret, out, out_len);
+	}
+
+	free(out);
+	free(path);
+	free(key);
+
+	return ret;
+}
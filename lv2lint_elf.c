@@ -0,0 +1,855 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <elf.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include <lv2lint.h>
+
+#define ELF_CACHE_MAX 16
+#define ELF_MAP_MIN (64 * 1024) // smaller binaries are cheaper to read than to map
+
+#ifndef NOTE_GNU_PROPERTY_SECTION_NAME
+#	define NOTE_GNU_PROPERTY_SECTION_NAME ".note.gnu.property"
+#endif
+
+typedef struct _reader_t reader_t;
+typedef struct _section_t section_t;
+typedef struct _name_list_t name_list_t;
+
+// zero-copy view on a mapped binary of either class and byte order
+struct _reader_t {
+	const uint8_t *map;
+	uint64_t size;
+	bool is_64;
+	bool is_msb;
+};
+
+struct _section_t {
+	const uint8_t *data; // NULL if not in file
+	uint64_t size;
+	uint64_t entsize;
+	uint64_t flags;
+	uint32_t type;
+	uint32_t link;
+	uint32_t name;
+};
+
+struct _name_list_t {
+	uint32_t n;
+	uint32_t max;
+	const char **names;
+};
+
+static uint64_t
+_read(const reader_t *rd, const uint8_t *ptr, size_t len)
+{
+	uint64_t val = 0;
+
+	if(rd->is_msb)
+	{
+		for(size_t i = 0; i < len; i++)
+		{
+			val = (val << 8) | ptr[i];
+		}
+	}
+	else
+	{
+		for(size_t i = len; i > 0; i--)
+		{
+			val = (val << 8) | ptr[i - 1];
+		}
+	}
+
+	return val;
+}
+
+// read field F of structure T at PTR in the class and byte order of the binary
+#define FIELD(RD, PTR, T, F) \
+	_read((RD), (PTR) + ( (RD)->is_64 ? offsetof(Elf64_##T, F) : offsetof(Elf32_##T, F) ), \
+		(RD)->is_64 ? sizeof(((Elf64_##T *)NULL)->F) : sizeof(((Elf32_##T *)NULL)->F) )
+
+#define SIZE(RD, T) \
+	( (RD)->is_64 ? sizeof(Elf64_##T) : sizeof(Elf32_##T) )
+
+static bool
+_in_file(const reader_t *rd, uint64_t off, uint64_t len)
+{
+	return (off <= rd->size) && (len <= rd->size - off);
+}
+
+static const char *
+_string(const section_t *strtab, uint64_t off)
+{
+	if(!strtab->data || (strtab->type != SHT_STRTAB) || (off >= strtab->size) )
+	{
+		return NULL;
+	}
+
+	const char *str = (const char *)strtab->data + off;
+
+	// must be terminated inside of the string table
+	return memchr(str, '\0', strtab->size - off) ? str : NULL;
+}
+
+static int
+_name_list_push(name_list_t *list, const char *name)
+{
+	if(list->n == list->max)
+	{
+		const uint32_t max = list->max ? list->max * 2 : 64;
+		const char **names = realloc(list->names, max * sizeof(const char *));
+
+		if(!names)
+		{
+			return -1;
+		}
+
+		list->names = names;
+		list->max = max;
+	}
+
+	list->names[list->n++] = name;
+
+	return 0;
+}
+
+static void
+_facts_free(elf_facts_t *facts)
+{
+	lv2lint_hashset_deinit(&facts->symbols);
+	free(facts->exports);
+	free(facts->imports);
+	free(facts->needed);
+	free(facts->sections);
+	free(facts->path);
+
+	if(facts->is_mapped)
+	{
+		munmap(facts->map, facts->map_size);
+	}
+	else
+	{
+		free(facts->map);
+	}
+
+	free(facts);
+}
+
+static section_t *
+_sections_parse(const reader_t *rd, uint32_t *n_sections, uint32_t *shstrndx)
+{
+	const uint8_t *ehdr = rd->map;
+	const uint64_t shoff = FIELD(rd, ehdr, Ehdr, e_shoff);
+	const uint64_t shentsize = FIELD(rd, ehdr, Ehdr, e_shentsize);
+	uint64_t shnum = FIELD(rd, ehdr, Ehdr, e_shnum);
+
+	*shstrndx = FIELD(rd, ehdr, Ehdr, e_shstrndx);
+
+	if(!shoff || (shentsize < SIZE(rd, Shdr)) || !_in_file(rd, shoff, shentsize) )
+	{
+		return NULL;
+	}
+
+	// extended numbering is stored in the first section header
+	if(shnum == 0)
+	{
+		shnum = FIELD(rd, rd->map + shoff, Shdr, sh_size);
+	}
+
+	if(*shstrndx == SHN_XINDEX)
+	{
+		*shstrndx = FIELD(rd, rd->map + shoff, Shdr, sh_link);
+	}
+
+	if(!shnum || (shnum > UINT32_MAX) || !_in_file(rd, shoff, shnum * shentsize) )
+	{
+		return NULL;
+	}
+
+	section_t *sections = calloc(shnum, sizeof(section_t));
+
+	if(!sections)
+	{
+		return NULL;
+	}
+
+	for(uint64_t i = 0; i < shnum; i++)
+	{
+		const uint8_t *shdr = rd->map + shoff + i*shentsize;
+		section_t *section = &sections[i];
+		const uint64_t offset = FIELD(rd, shdr, Shdr, sh_offset);
+
+		section->size = FIELD(rd, shdr, Shdr, sh_size);
+		section->entsize = FIELD(rd, shdr, Shdr, sh_entsize);
+		section->flags = FIELD(rd, shdr, Shdr, sh_flags);
+		section->type = FIELD(rd, shdr, Shdr, sh_type);
+		section->link = FIELD(rd, shdr, Shdr, sh_link);
+		section->name = FIELD(rd, shdr, Shdr, sh_name);
+
+		if( (section->type != SHT_NOBITS) && _in_file(rd, offset, section->size) )
+		{
+			section->data = rd->map + offset;
+		}
+	}
+
+	*n_sections = shnum;
+
+	return sections;
+}
+
+static const section_t *
+_linked(const section_t *sections, uint32_t n_sections, const section_t *section)
+{
+	return (section->link < n_sections)
+		? &sections[section->link]
+		: NULL;
+}
+
+static void
+_hash_table(elf_facts_t *facts, const reader_t *rd, const section_t *sections,
+	uint32_t n_sections, const section_t *section)
+{
+	const section_t *dynsym = _linked(sections, n_sections, section);
+	const section_t *dynstr = dynsym
+		? _linked(sections, n_sections, dynsym)
+		: NULL;
+
+	if(  !section->data || !dynsym || !dynstr
+		|| (dynsym->type != SHT_DYNSYM) || !dynsym->data
+		|| (dynsym->entsize < SIZE(rd, Sym))
+		|| (dynstr->type != SHT_STRTAB) || !dynstr->data )
+	{
+		return;
+	}
+
+	elf_table_t *table = (section->type == SHT_HASH)
+		? &facts->hash
+		: &facts->gnu_hash;
+
+	table->data = section->data;
+	table->size = section->size;
+	table->entsize = section->entsize;
+
+	facts->dynsym.data = dynsym->data;
+	facts->dynsym.size = dynsym->size;
+	facts->dynsym.entsize = dynsym->entsize;
+
+	facts->dynstr.data = dynstr->data;
+	facts->dynstr.size = dynstr->size;
+}
+
+static uint64_t
+_align(uint64_t off, uint64_t align)
+{
+	return (off + align - 1) & ~(align - 1);
+}
+
+// notes of type NT_GNU_PROPERTY_TYPE_0 with an array of properties
+static void
+_gnu_properties(elf_facts_t *facts, const reader_t *rd, const section_t *section)
+{
+	const uint64_t align = rd->is_64 ? 8 : 4;
+	const uint8_t *data = section->data;
+	const uint64_t size = data ? section->size : 0;
+
+	for(uint64_t off = 0; off + 12 <= size; )
+	{
+		const uint64_t namesz = _read(rd, data + off, 4);
+		const uint64_t descsz = _read(rd, data + off + 4, 4);
+		const uint32_t type = _read(rd, data + off + 8, 4);
+		const uint64_t name = off + 12;
+		const uint64_t desc = name + _align(namesz, 4);
+		const uint64_t end = desc + descsz;
+
+		if( (desc > size) || (end > size) )
+		{
+			return;
+		}
+
+		if(  (type == LV2LINT_NT_GNU_PROPERTY_TYPE_0)
+			&& (namesz == sizeof(ELF_NOTE_GNU))
+			&& !memcmp(data + name, ELF_NOTE_GNU, namesz) )
+		{
+			for(uint64_t pr = desc; pr + 8 <= end; )
+			{
+				const uint32_t pr_type = _read(rd, data + pr, 4);
+				const uint64_t pr_datasz = _read(rd, data + pr + 4, 4);
+				const uint64_t pr_data = pr + 8;
+
+				if(pr_data + pr_datasz > end)
+				{
+					break;
+				}
+
+				const uint32_t val = (pr_datasz == 4)
+					? _read(rd, data + pr_data, 4)
+					: 0;
+
+				switch(pr_type)
+				{
+					case LV2LINT_GNU_PROPERTY_X86_ISA_1_NEEDED:
+					{
+						facts->x86_isa_needed |= val;
+					} break;
+					case LV2LINT_GNU_PROPERTY_X86_ISA_1_USED:
+					{
+						facts->x86_isa_used |= val;
+					} break;
+					case LV2LINT_GNU_PROPERTY_X86_FEATURE_2_USED:
+					{
+						facts->x86_feature_2_used |= val;
+					} break;
+				}
+
+				pr = _align(pr_data + pr_datasz, align);
+			}
+		}
+
+		off = _align(end, align);
+	}
+}
+
+static int
+_facts_scan(elf_facts_t *facts, const reader_t *rd)
+{
+	name_list_t exports = { .n = 0 };
+	name_list_t imports = { .n = 0 };
+	name_list_t needed = { .n = 0 };
+	bool has_symtab = false;
+	bool has_dynamic = false;
+	uint32_t n_sections = 0;
+	uint32_t shstrndx = 0;
+	uint64_t n_symbols = 0;
+	int ret = -1;
+
+	section_t *sections = _sections_parse(rd, &n_sections, &shstrndx);
+
+	if(!sections)
+	{
+		return -1;
+	}
+
+	facts->sections = calloc(n_sections, sizeof(elf_section_t));
+
+	if(!facts->sections)
+	{
+		goto fail;
+	}
+
+	for(uint32_t i = 0; i < n_sections; i++)
+	{
+		const section_t *section = &sections[i];
+		elf_section_t *dst = &facts->sections[i];
+		const char *name = (shstrndx < n_sections)
+			? _string(&sections[shstrndx], section->name)
+			: NULL;
+
+		dst->name = name ? name : "";
+		dst->type = section->type;
+		dst->flags = section->flags;
+		dst->size = section->size;
+
+		if( (section->type == SHT_SYMTAB) || (section->type == SHT_DYNSYM) )
+		{
+			n_symbols += section->entsize
+				? section->size / section->entsize
+				: 0;
+		}
+		else if( (section->type == SHT_HASH) || (section->type == SHT_GNU_HASH) )
+		{
+			_hash_table(facts, rd, sections, n_sections, section);
+		}
+		else if( (section->type == SHT_NOTE)
+			&& !strcmp(dst->name, NOTE_GNU_PROPERTY_SECTION_NAME) )
+		{
+			_gnu_properties(facts, rd, section);
+		}
+	}
+
+	facts->n_sections = n_sections;
+
+	// hash names the binary's own hash tables do not cover ourselves
+	const bool has_hash = facts->hash.data || facts->gnu_hash.data;
+
+	if(  (n_symbols > UINT32_MAX / 2)
+		|| lv2lint_hashset_init(&facts->symbols, n_symbols) )
+	{
+		goto fail;
+	}
+
+	for(uint32_t i = 0; i < n_sections; i++)
+	{
+		const section_t *section = &sections[i];
+		const section_t *strtab = _linked(sections, n_sections, section);
+
+		if(!section->data || !strtab || (section->entsize == 0) )
+		{
+			continue;
+		}
+
+		const uint64_t count = section->size / section->entsize;
+
+		if( (section->type == SHT_SYMTAB) || (section->type == SHT_DYNSYM) )
+		{
+			if(section->entsize < SIZE(rd, Sym))
+			{
+				continue;
+			}
+
+			// walk symbol table in place
+			for(uint64_t j = 0; j < count; j++)
+			{
+				const uint8_t *sym = section->data + j*section->entsize;
+				const char *name = _string(strtab, FIELD(rd, sym, Sym, st_name));
+
+				if(!name || !*name)
+				{
+					continue;
+				}
+
+				const uint8_t info = FIELD(rd, sym, Sym, st_info);
+				const uint64_t value = FIELD(rd, sym, Sym, st_value);
+				const uint16_t shndx = FIELD(rd, sym, Sym, st_shndx);
+
+				// defined .dynsym symbols are looked up via DT_HASH/DT_GNU_HASH
+				if(  !has_hash || (section->type != SHT_DYNSYM)
+					|| (shndx == SHN_UNDEF) )
+				{
+					bool is_new;
+
+					lv2lint_hashset_insert(&facts->symbols, name, 0, &is_new);
+				}
+
+				// exported globals are taken from the first symbol table only
+				if(!has_symtab && value && (ELF64_ST_BIND(info) == STB_GLOBAL)
+					&& _name_list_push(&exports, name) )
+				{
+					goto fail;
+				}
+
+				// imports are resolved by the dynamic linker via .dynsym
+				if( (section->type == SHT_DYNSYM) && (shndx == SHN_UNDEF)
+					&& _name_list_push(&imports, name) )
+				{
+					goto fail;
+				}
+			}
+
+			has_symtab = true;
+		}
+		else if( (section->type == SHT_DYNAMIC) && !has_dynamic)
+		{
+			if(section->entsize < SIZE(rd, Dyn))
+			{
+				continue;
+			}
+
+			// walk dynamic section in place
+			for(uint64_t j = 0; j < count; j++)
+			{
+				const uint8_t *dyn = section->data + j*section->entsize;
+				const uint64_t tag = FIELD(rd, dyn, Dyn, d_tag);
+
+				if(tag == DT_NULL)
+				{
+					break;
+				}
+
+				if(tag != DT_NEEDED)
+				{
+					continue;
+				}
+
+				const char *name = _string(strtab, FIELD(rd, dyn, Dyn, d_un));
+
+				if(name && _name_list_push(&needed, name))
+				{
+					goto fail;
+				}
+			}
+
+			has_dynamic = true;
+		}
+	}
+
+	ret = 0;
+
+fail:
+	facts->n_exports = exports.n;
+	facts->exports = exports.names;
+	facts->n_imports = imports.n;
+	facts->imports = imports.names;
+	facts->n_needed = needed.n;
+	facts->needed = needed.names;
+
+	free(sections);
+
+	return ret;
+}
+
+static elf_facts_t *
+_facts_new(const char *path, int fd, const struct stat *st)
+{
+	if(st->st_size < EI_NIDENT)
+	{
+		return NULL;
+	}
+
+	elf_facts_t *facts = calloc(1, sizeof(elf_facts_t));
+
+	if(!facts)
+	{
+		return NULL;
+	}
+
+	facts->path = strdup(path);
+	facts->dev = st->st_dev;
+	facts->ino = st->st_ino;
+	facts->mtime = st->st_mtime;
+	facts->size = st->st_size;
+
+	// names point into the mapping, it is kept as long as the facts
+	if(st->st_size >= ELF_MAP_MIN)
+	{
+		void *map = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if(map != MAP_FAILED)
+		{
+			facts->map = map;
+			facts->map_size = st->st_size;
+			facts->is_mapped = true;
+		}
+	}
+	else
+	{
+		void *buf = malloc(st->st_size);
+
+		if(buf && (pread(fd, buf, st->st_size, 0) == st->st_size) )
+		{
+			facts->map = buf;
+			facts->map_size = st->st_size;
+		}
+		else
+		{
+			free(buf);
+		}
+	}
+
+	if(!facts->path || !facts->map)
+	{
+		_facts_free(facts);
+		return NULL;
+	}
+
+	const uint8_t *ident = facts->map;
+	const reader_t rd = {
+		.map = facts->map,
+		.size = facts->map_size,
+		.is_64 = ident[EI_CLASS] == ELFCLASS64,
+		.is_msb = ident[EI_DATA] == ELFDATA2MSB
+	};
+
+	facts->is_64 = rd.is_64;
+	facts->is_msb = rd.is_msb;
+
+	if(  memcmp(ident, ELFMAG, SELFMAG)
+		|| ( (ident[EI_CLASS] != ELFCLASS32) && (ident[EI_CLASS] != ELFCLASS64) )
+		|| ( (ident[EI_DATA] != ELFDATA2LSB) && (ident[EI_DATA] != ELFDATA2MSB) )
+		|| !_in_file(&rd, 0, SIZE(&rd, Ehdr))
+		|| _facts_scan(facts, &rd) )
+	{
+		_facts_free(facts);
+		return NULL;
+	}
+
+	facts->machine = FIELD(&rd, rd.map, Ehdr, e_machine);
+
+	return facts;
+}
+
+const elf_facts_t *
+lv2lint_elf_facts(app_t *app, const char *path)
+{
+	struct stat st;
+	const int fd = open(path, O_RDONLY);
+
+	if(fd == -1)
+	{
+		return NULL;
+	}
+
+	if(fstat(fd, &st) == -1)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	// look up by path and inode, move hits to the front of the list
+	elf_facts_t **last = NULL;
+	unsigned n_facts = 0;
+
+	for(elf_facts_t **facts = &app->elf_facts; *facts; facts = &(*facts)->next)
+	{
+		elf_facts_t *hit = *facts;
+
+		if(  (hit->dev == (uint64_t)st.st_dev)
+			&& (hit->ino == (uint64_t)st.st_ino)
+			&& (hit->mtime == (int64_t)st.st_mtime)
+			&& (hit->size == (int64_t)st.st_size)
+			&& !strcmp(hit->path, path) )
+		{
+			*facts = hit->next;
+			hit->next = app->elf_facts;
+			app->elf_facts = hit;
+
+			close(fd);
+			return hit;
+		}
+
+		last = facts;
+		n_facts++;
+	}
+
+	const uint64_t t0 = lv2lint_now();
+	elf_facts_t *facts = _facts_new(path, fd, &st);
+
+	close(fd);
+	lv2lint_timing(app, TIMING_PHASE, "ELF Scan", t0);
+
+	if(!facts)
+	{
+		return NULL;
+	}
+
+	// drop least recently used entry
+	if(last && (n_facts >= ELF_CACHE_MAX) )
+	{
+		_facts_free(*last);
+		*last = NULL;
+	}
+
+	facts->next = app->elf_facts;
+	app->elf_facts = facts;
+
+	return facts;
+}
+
+static bool
+_dynsym_is(const elf_facts_t *facts, const reader_t *rd, uint64_t idx,
+	const char *name)
+{
+	const elf_table_t *dynsym = &facts->dynsym;
+
+	if(idx >= dynsym->size / dynsym->entsize)
+	{
+		return false;
+	}
+
+	const uint8_t *sym = dynsym->data + idx*dynsym->entsize;
+	const uint64_t off = FIELD(rd, sym, Sym, st_name);
+	const section_t dynstr = {
+		.data = facts->dynstr.data,
+		.size = facts->dynstr.size,
+		.type = SHT_STRTAB
+	};
+	const char *str = _string(&dynstr, off);
+
+	return str && !strcmp(str, name);
+}
+
+static uint32_t
+_sysv_hash(const char *name)
+{
+	uint32_t h = 0;
+
+	for(const uint8_t *c = (const uint8_t *)name; *c; c++)
+	{
+		h = (h << 4) + *c;
+
+		const uint32_t g = h & 0xf0000000;
+
+		if(g)
+		{
+			h ^= g >> 24;
+		}
+
+		h &= ~g;
+	}
+
+	return h;
+}
+
+static uint32_t
+_gnu_hash(const char *name)
+{
+	uint32_t h = 5381;
+
+	for(const uint8_t *c = (const uint8_t *)name; *c; c++)
+	{
+		h = (h << 5) + h + *c;
+	}
+
+	return h;
+}
+
+// nbucket, nchain, bucket [nbucket], chain [nchain]
+static bool
+_hash_lookup(const elf_facts_t *facts, const reader_t *rd, const char *name)
+{
+	const elf_table_t *table = &facts->hash;
+	// words are 8 bytes wide on some targets, e.g. s390x and alpha
+	const unsigned word = (table->entsize == 8) ? 8 : 4;
+	const uint64_t n_words = table->size / word;
+
+	if(n_words < 2)
+	{
+		return false;
+	}
+
+	const uint64_t nbucket = _read(rd, table->data, word);
+	const uint64_t nchain = _read(rd, table->data + word, word);
+
+	if(  !nbucket || (nbucket > n_words) || (nchain > n_words)
+		|| (2 + nbucket + nchain > n_words) )
+	{
+		return false;
+	}
+
+	const uint8_t *bucket = table->data + 2*word;
+	const uint8_t *chain = bucket + word*nbucket;
+	uint64_t idx = _read(rd, bucket + word*(_sysv_hash(name) % nbucket), word);
+
+	// bound walk by chain length to not loop forever on broken tables
+	for(uint64_t n = 0; (idx != STN_UNDEF) && (idx < nchain) && (n < nchain); n++)
+	{
+		if(_dynsym_is(facts, rd, idx, name))
+		{
+			return true;
+		}
+
+		idx = _read(rd, chain + word*idx, word);
+	}
+
+	return false;
+}
+
+// nbuckets, symoffset, bloom_size, bloom_shift, bloom [bloom_size],
+// buckets [nbuckets], chain [n_dynsym - symoffset]
+static bool
+_gnu_hash_lookup(const elf_facts_t *facts, const reader_t *rd, const char *name)
+{
+	const elf_table_t *table = &facts->gnu_hash;
+	const uint64_t n_dynsym = facts->dynsym.size / facts->dynsym.entsize;
+	const unsigned word = rd->is_64 ? 8 : 4;
+
+	if(table->size < 16)
+	{
+		return false;
+	}
+
+	const uint32_t nbuckets = _read(rd, table->data, 4);
+	const uint32_t symoffset = _read(rd, table->data + 4, 4);
+	const uint32_t bloom_size = _read(rd, table->data + 8, 4);
+	const uint32_t bloom_shift = _read(rd, table->data + 12, 4);
+	const uint8_t *bloom = table->data + 16;
+	const uint8_t *buckets = bloom + (uint64_t)bloom_size*word;
+	const uint8_t *chain = buckets + 4*(uint64_t)nbuckets;
+	const uint8_t *end = table->data + table->size;
+
+	if(  !nbuckets || !bloom_size || (symoffset > n_dynsym)
+		|| (chain > end) || ( (uint64_t)(end - chain) / 4 < n_dynsym - symoffset) )
+	{
+		return false;
+	}
+
+	const uint32_t h = _gnu_hash(name);
+	const unsigned bits = word * 8;
+	const uint64_t mask = (1ULL << (h % bits)) | (1ULL << ((h >> bloom_shift) % bits));
+	const uint64_t filter = _read(rd, bloom + word*((h / bits) % bloom_size), word);
+
+	if( (filter & mask) != mask)
+	{
+		return false;
+	}
+
+	for(uint64_t idx = _read(rd, buckets + 4*(h % nbuckets), 4);
+		(idx >= symoffset) && (idx < n_dynsym);
+		idx++)
+	{
+		const uint32_t h2 = _read(rd, chain + 4*(idx - symoffset), 4);
+
+		if( ((h | 1) == (h2 | 1)) && _dynsym_is(facts, rd, idx, name) )
+		{
+			return true;
+		}
+
+		if(h2 & 1) // end of chain
+		{
+			break;
+		}
+	}
+
+	return false;
+}
+
+bool
+lv2lint_elf_has_symbol(const elf_facts_t *facts, const char *name)
+{
+	const reader_t rd = {
+		.map = facts->map,
+		.size = facts->map_size,
+		.is_64 = facts->is_64,
+		.is_msb = facts->is_msb
+	};
+
+	// undefined and .symtab symbols, or all without hash tables
+	if(lv2lint_hashset_lookup(&facts->symbols, name))
+	{
+		return true;
+	}
+
+	// defined .dynsym symbols
+	if(facts->hash.data)
+	{
+		return _hash_lookup(facts, &rd, name);
+	}
+
+	if(facts->gnu_hash.data)
+	{
+		return _gnu_hash_lookup(facts, &rd, name);
+	}
+
+	return false;
+}
+
+void
+lv2lint_elf_free(app_t *app)
+{
+	for(elf_facts_t *facts = app->elf_facts, *next; facts; facts = next)
+	{
+		next = facts->next;
+
+		_facts_free(facts);
+	}
+
+	app->elf_facts = NULL;
+}
@@ -0,0 +1,646 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+
+#include <lv2lint.h>
+
+/*
+ * Machine-readable report sinks
+ *
+ * Every result is assembled in a string builder and written as a single line,
+ * so records stay intact when streamed from -j workers or -w sandboxes or
+ * replayed from the cache. Sinks needing more than a header and a footer
+ * filter the final output record by record: SARIF prefixes every result with
+ * a comma and drops the one of the very first, JUnit holds back the results
+ * of one plugin until its testsuite totals are known.
+ */
+
+typedef struct _sink_t sink_t;
+typedef struct _ctx_t ctx_t;
+typedef struct _filter_t filter_t;
+
+struct _ctx_t {
+	const char *plugin;
+	const char *port;
+	int port_index;
+	const char *parameter;
+	const char *ui;
+};
+
+struct _sink_t {
+	const char *name;
+	void (*begin)(app_t *app, strbuf_t *sb);
+	void (*result)(app_t *app, strbuf_t *sb, const ctx_t *ctx,
+		const test_t *test, const char *label, lint_t lnt, const ret_t *ret,
+		const char *msg, const char *docu);
+	void (*end)(app_t *app, strbuf_t *sb, int ret);
+	int (*record)(filter_t *filter, const char *rec, size_t len);
+	int (*flush)(filter_t *filter);
+	lint_t show; // reported regardless of -S
+};
+
+struct _filter_t {
+	const sink_t *sink;
+	FILE *out;
+	strbuf_t line; // incomplete record
+	bool is_first;
+	strbuf_t suite; // plugin of pending JUnit testcases
+	strbuf_t cases;
+	unsigned n_tests;
+	unsigned n_failures;
+	unsigned n_skipped;
+};
+
+static void
+_json_string(strbuf_t *sb, const char *str)
+{
+	lv2lint_strbuf_putc(sb, '"');
+
+	for(const char *ptr = str; ptr && *ptr; ptr++)
+	{
+		const unsigned char c = *ptr;
+
+		switch(c)
+		{
+			case '"':
+				lv2lint_strbuf_puts(sb, "\\\"");
+				break;
+			case '\\':
+				lv2lint_strbuf_puts(sb, "\\\\");
+				break;
+			case '\n':
+				lv2lint_strbuf_puts(sb, "\\n");
+				break;
+			case '\t':
+				lv2lint_strbuf_puts(sb, "\\t");
+				break;
+			default:
+				if(c < 0x20)
+				{
+					lv2lint_strbuf_printf(sb, "\\u%04x", c);
+				}
+				else
+				{
+					lv2lint_strbuf_putc(sb, c);
+				}
+				break;
+		}
+	}
+
+	lv2lint_strbuf_putc(sb, '"');
+}
+
+static void
+_json_member(strbuf_t *sb, const char *key, const char *val)
+{
+	if(!val)
+	{
+		return;
+	}
+
+	lv2lint_strbuf_printf(sb, ",\"%s\":", key);
+	_json_string(sb, val);
+}
+
+static void
+_xml_string(strbuf_t *sb, const char *str)
+{
+	for(const char *ptr = str; ptr && *ptr; ptr++)
+	{
+		const unsigned char c = *ptr;
+
+		switch(c)
+		{
+			case '&':
+				lv2lint_strbuf_puts(sb, "&amp;");
+				break;
+			case '<':
+				lv2lint_strbuf_puts(sb, "&lt;");
+				break;
+			case '>':
+				lv2lint_strbuf_puts(sb, "&gt;");
+				break;
+			case '"':
+				lv2lint_strbuf_puts(sb, "&quot;");
+				break;
+			case '\'':
+				lv2lint_strbuf_puts(sb, "&apos;");
+				break;
+			default:
+				if(c < 0x20) // keep records on a single line
+				{
+					lv2lint_strbuf_printf(sb, "&#%u;", c);
+				}
+				else
+				{
+					lv2lint_strbuf_putc(sb, c);
+				}
+				break;
+		}
+	}
+}
+
+static void
+_jsonl_result(app_t *app __unused, strbuf_t *sb, const ctx_t *ctx,
+	const test_t *test, const char *label, lint_t lnt __unused, const ret_t *ret,
+	const char *msg, const char *docu)
+{
+	lv2lint_strbuf_puts(sb, "{\"plugin\":");
+	_json_string(sb, ctx->plugin);
+
+	if(ctx->port)
+	{
+		lv2lint_strbuf_printf(sb, ",\"port\":{\"index\":%i,\"symbol\":", ctx->port_index);
+		_json_string(sb, ctx->port);
+		lv2lint_strbuf_putc(sb, '}');
+	}
+
+	_json_member(sb, "parameter", ctx->parameter);
+	_json_member(sb, "ui", ctx->ui);
+	_json_member(sb, "test", test->id);
+	_json_member(sb, "level", label);
+	_json_member(sb, "message", msg);
+	_json_member(sb, "seeAlso", ret ? ret->uri : NULL);
+	_json_member(sb, "documentation", docu);
+
+	lv2lint_strbuf_puts(sb, "}\n");
+}
+
+static int
+_filter_put(filter_t *filter, const char *buf, size_t len)
+{
+	return (fwrite(buf, 1, len, filter->out) == len) ? 0 : -1;
+}
+
+static void
+_junit_begin(app_t *app __unused, strbuf_t *sb)
+{
+	lv2lint_strbuf_puts(sb,
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<testsuites name=\"lv2lint\">\n");
+}
+
+static void
+_junit_result(app_t *app, strbuf_t *sb, const ctx_t *ctx,
+	const test_t *test, const char *label, lint_t lnt, const ret_t *ret,
+	const char *msg, const char *docu)
+{
+	lv2lint_strbuf_puts(sb, "<testcase classname=\"");
+	_xml_string(sb, ctx->plugin);
+	lv2lint_strbuf_puts(sb, "\" name=\"");
+
+	if(ctx->port)
+	{
+		lv2lint_strbuf_printf(sb, "{%i : ", ctx->port_index);
+		_xml_string(sb, ctx->port);
+		lv2lint_strbuf_puts(sb, "} ");
+	}
+	else if(ctx->parameter || ctx->ui)
+	{
+		lv2lint_strbuf_puts(sb, "<");
+		_xml_string(sb, ctx->parameter ? ctx->parameter : ctx->ui);
+		lv2lint_strbuf_puts(sb, "> ");
+	}
+
+	_xml_string(sb, test->id);
+	lv2lint_strbuf_puts(sb, "\">");
+
+	if(!ret) // passed
+	{
+		// nothing to add
+	}
+	else if(!strcmp(label, "SKIP"))
+	{
+		lv2lint_strbuf_puts(sb, "<skipped message=\"");
+		_xml_string(sb, msg);
+		lv2lint_strbuf_puts(sb, "\"/>");
+	}
+	else
+	{
+		// findings not failing the run are only reported as output
+		const char *elem = (lnt & app->mask)
+			? "failure"
+			: "system-out";
+
+		if(lnt & app->mask)
+		{
+			lv2lint_strbuf_printf(sb, "<%s type=\"%s\" message=\"", elem, label);
+			_xml_string(sb, msg);
+			lv2lint_strbuf_puts(sb, "\">");
+		}
+		else
+		{
+			lv2lint_strbuf_printf(sb, "<%s>%s: ", elem, label);
+			_xml_string(sb, msg);
+			lv2lint_strbuf_puts(sb, "&#10;");
+		}
+
+		lv2lint_strbuf_puts(sb, "seeAlso: ");
+		_xml_string(sb, ret->uri);
+
+		if(docu)
+		{
+			lv2lint_strbuf_puts(sb, "&#10;");
+			_xml_string(sb, docu);
+		}
+
+		lv2lint_strbuf_printf(sb, "</%s>", elem);
+	}
+
+	lv2lint_strbuf_puts(sb, "</testcase>\n");
+}
+
+static void
+_junit_end(app_t *app __unused, strbuf_t *sb, int ret __unused)
+{
+	lv2lint_strbuf_puts(sb, "</testsuites>\n");
+}
+
+// one testsuite per plugin, its name is still escaped from the classname
+static int
+_junit_flush(filter_t *filter)
+{
+	int ret = 0;
+
+	if(filter->n_tests)
+	{
+		ret = (fprintf(filter->out, "<testsuite name=\"%s\" tests=\"%u\" "
+				"failures=\"%u\" errors=\"0\" skipped=\"%u\">\n",
+				filter->suite.buf ? filter->suite.buf : "",
+				filter->n_tests, filter->n_failures, filter->n_skipped) < 0)
+			|| _filter_put(filter, filter->cases.buf, filter->cases.len)
+			|| (fputs("</testsuite>\n", filter->out) == EOF);
+	}
+	else if(filter->cases.len)
+	{
+		ret = _filter_put(filter, filter->cases.buf, filter->cases.len);
+	}
+
+	lv2lint_strbuf_reset(&filter->suite);
+	lv2lint_strbuf_reset(&filter->cases);
+	filter->n_tests = 0;
+	filter->n_failures = 0;
+	filter->n_skipped = 0;
+
+	return ret ? -1 : 0;
+}
+
+static int
+_junit_record(filter_t *filter, const char *rec, size_t len)
+{
+	static const char prefix [] = "<testcase classname=\"";
+	const size_t prefix_len = sizeof(prefix) - 1;
+	const char *name = rec + prefix_len;
+	const char *quote = (len > prefix_len) && !memcmp(rec, prefix, prefix_len)
+		? memchr(name, '"', len - prefix_len)
+		: NULL;
+
+	if(!quote) // not a testcase, keep it in place
+	{
+		return filter->n_tests
+			? lv2lint_strbuf_append(&filter->cases, rec, len)
+			: _filter_put(filter, rec, len);
+	}
+
+	const size_t name_len = quote - name;
+	const size_t rest = len - (quote - rec);
+
+	if(  (filter->suite.len != name_len)
+		|| (name_len && memcmp(filter->suite.buf, name, name_len)) )
+	{
+		if(  _junit_flush(filter)
+			|| lv2lint_strbuf_append(&filter->suite, name, name_len) )
+		{
+			return -1;
+		}
+	}
+
+	// markup in names and messages is escaped, these are the elements
+	if(memmem(quote, rest, "<failure ", 9))
+	{
+		filter->n_failures++;
+	}
+	else if(memmem(quote, rest, "<skipped ", 9))
+	{
+		filter->n_skipped++;
+	}
+
+	filter->n_tests++;
+
+	return lv2lint_strbuf_append(&filter->cases, rec, len);
+}
+
+static void
+_sarif_begin(app_t *app __unused, strbuf_t *sb)
+{
+	lv2lint_strbuf_puts(sb,
+		"{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\","
+		"\"version\":\"2.1.0\",\"runs\":[{\"tool\":{\"driver\":{\"name\":\"lv2lint\","
+		"\"version\":\""LV2LINT_VERSION"\","
+		"\"informationUri\":\"https://open-music-kontrollers.ch/lv2/lv2lint\"}},"
+		"\"results\":[\n");
+}
+
+static void
+_sarif_result(app_t *app __unused, strbuf_t *sb, const ctx_t *ctx,
+	const test_t *test, const char *label, lint_t lnt, const ret_t *ret,
+	const char *msg, const char *docu)
+{
+	const char *kind = "fail";
+	const char *level = "none";
+
+	if(!ret)
+	{
+		kind = "pass";
+	}
+	else if(!strcmp(label, "SKIP"))
+	{
+		kind = "notApplicable";
+	}
+	else if(lnt & LINT_FAIL)
+	{
+		level = "error";
+	}
+	else if(lnt & LINT_WARN)
+	{
+		level = "warning";
+	}
+	else
+	{
+		level = "note";
+	}
+
+	lv2lint_strbuf_puts(sb, ",{\"ruleId\":");
+	_json_string(sb, test->id);
+	lv2lint_strbuf_printf(sb, ",\"kind\":\"%s\",\"level\":\"%s\",\"message\":{\"text\":", kind, level);
+	_json_string(sb, msg ? msg : test->id);
+	lv2lint_strbuf_printf(sb, "},\"locations\":[{\"logicalLocations\":[{\"kind\":\"module\","
+		"\"fullyQualifiedName\":");
+	_json_string(sb, ctx->plugin);
+	lv2lint_strbuf_puts(sb, "}]}],\"properties\":{\"lv2lint\":");
+	_json_string(sb, label);
+
+	if(ctx->port)
+	{
+		lv2lint_strbuf_printf(sb, ",\"portIndex\":%i", ctx->port_index);
+		_json_member(sb, "port", ctx->port);
+	}
+
+	_json_member(sb, "parameter", ctx->parameter);
+	_json_member(sb, "ui", ctx->ui);
+	_json_member(sb, "seeAlso", ret ? ret->uri : NULL);
+	_json_member(sb, "documentation", docu);
+
+	lv2lint_strbuf_puts(sb, "}}\n");
+}
+
+static void
+_sarif_end(app_t *app __unused, strbuf_t *sb, int ret __unused)
+{
+	lv2lint_strbuf_puts(sb, "]}]}\n");
+}
+
+// drops the separator of the first record written after the header
+static int
+_sarif_record(filter_t *filter, const char *rec, size_t len)
+{
+	size_t skip = 0;
+
+	if(filter->is_first)
+	{
+		skip = (rec[0] == ',') ? 1 : 0;
+		filter->is_first = false;
+	}
+
+	return _filter_put(filter, rec + skip, len - skip);
+}
+
+// splits the output into records, which may span several writes
+static ssize_t
+_filter_write(void *data, const char *buf, size_t len)
+{
+	filter_t *filter = data;
+	strbuf_t *line = &filter->line;
+	size_t off = 0;
+
+	if(lv2lint_strbuf_append(line, buf, len))
+	{
+		return -1;
+	}
+
+	for(const char *nl = memchr(line->buf, '\n', line->len);
+		nl;
+		nl = memchr(line->buf + off, '\n', line->len - off))
+	{
+		const size_t end = nl - line->buf + 1;
+
+		if(filter->sink->record(filter, line->buf + off, end - off))
+		{
+			return -1;
+		}
+
+		off = end;
+	}
+
+	memmove(line->buf, line->buf + off, line->len - off);
+	line->len -= off;
+	line->buf[line->len] = '\0';
+
+	return len;
+}
+
+static int
+_filter_close(void *data)
+{
+	filter_t *filter = data;
+	int ret = 0;
+
+	if(filter->line.len) // unterminated last record
+	{
+		ret |= filter->sink->record(filter, filter->line.buf, filter->line.len);
+	}
+
+	if(filter->sink->flush)
+	{
+		ret |= filter->sink->flush(filter);
+	}
+
+	lv2lint_strbuf_free(&filter->line);
+	lv2lint_strbuf_free(&filter->suite);
+	lv2lint_strbuf_free(&filter->cases);
+	free(filter);
+
+	return ret ? -1 : 0;
+}
+
+// write whole records at once
+static void
+_flush(app_t *app, strbuf_t *sb)
+{
+	if(sb->len)
+	{
+		fwrite(sb->buf, 1, sb->len, app->out);
+	}
+
+	lv2lint_strbuf_free(sb);
+}
+
+static const sink_t sinks [FORMAT_MAX] = {
+	[FORMAT_TEXT] = {
+		.name = "text"
+	},
+	[FORMAT_JSONL] = {
+		.name = "jsonl",
+		.result = _jsonl_result
+	},
+	[FORMAT_JUNIT] = {
+		.name = "junit",
+		.begin = _junit_begin,
+		.result = _junit_result,
+		.end = _junit_end,
+		.record = _junit_record,
+		.flush = _junit_flush,
+		.show = LINT_FAIL | LINT_WARN | LINT_NOTE | LINT_PASS // for totals
+	},
+	[FORMAT_SARIF] = {
+		.name = "sarif",
+		.begin = _sarif_begin,
+		.result = _sarif_result,
+		.end = _sarif_end,
+		.record = _sarif_record
+	}
+};
+
+int
+lv2lint_format_parse(app_t *app, const char *name)
+{
+	for(unsigned i = 0; i < FORMAT_MAX; i++)
+	{
+		if(!strcmp(sinks[i].name, name))
+		{
+			app->format = i;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+void
+lv2lint_format_begin(app_t *app)
+{
+	const sink_t *sink = &sinks[app->format];
+
+	if(sink->begin)
+	{
+		strbuf_t sb = { .buf = NULL };
+
+		sink->begin(app, &sb);
+		_flush(app, &sb);
+	}
+
+	app->show |= sink->show;
+
+	if(sink->record)
+	{
+		static const cookie_io_functions_t io = {
+			.write = _filter_write,
+			.close = _filter_close
+		};
+		filter_t *filter = calloc(1, sizeof(filter_t));
+
+		// relayed worker and replayed cache output pass through here, too
+		FILE *out = filter
+			? fopencookie(filter, "w", io)
+			: NULL;
+
+		if(out)
+		{
+			filter->sink = sink;
+			filter->out = app->out;
+			filter->is_first = true;
+
+			app->format_out = app->out;
+			app->out = out;
+		}
+		else
+		{
+			free(filter);
+		}
+	}
+}
+
+void
+lv2lint_format_result(app_t *app, const test_t *test, const char *label,
+	lint_t lnt, const ret_t *ret, const char *msg, const char *docu)
+{
+	const sink_t *sink = &sinks[app->format];
+	ctx_t ctx = {
+		.plugin = app->plugin_uri
+	};
+
+	if(!sink->result)
+	{
+		return;
+	}
+
+	if(app->port_info)
+	{
+		ctx.port = lilv_node_as_string(app->port_info->symbol);
+		ctx.port_index = app->port_info->index;
+	}
+
+	if(app->parameter)
+	{
+		ctx.parameter = lilv_node_as_uri(app->parameter);
+	}
+
+	if(app->ui)
+	{
+		ctx.ui = lilv_node_as_uri(lilv_ui_get_uri(app->ui));
+	}
+
+	strbuf_t sb = { .buf = NULL };
+
+	sink->result(app, &sb, &ctx, test, label, lnt, ret, msg, docu);
+	_flush(app, &sb);
+}
+
+void
+lv2lint_format_end(app_t *app, int ret)
+{
+	const sink_t *sink = &sinks[app->format];
+
+	if(app->format_out)
+	{
+		fclose(app->out);
+
+		app->out = app->format_out;
+		app->format_out = NULL;
+	}
+
+	if(sink->end)
+	{
+		strbuf_t sb = { .buf = NULL };
+
+		sink->end(app, &sb, ret);
+		_flush(app, &sb);
+	}
+
+	fflush(app->out);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <lv2lint.h>
+
+#define HASHSET_MIN_SIZE 16
+
+uint32_t
+lv2lint_hash(const char *str)
+{
+	const uint64_t hash = lv2lint_fnv1a(LV2LINT_FNV1A_INIT, str, strlen(str));
+
+	return hash ^ (hash >> 32); // fold
+}
+
+int
+lv2lint_hashset_init(hashset_t *set, uint32_t n_keys)
+{
+	uint32_t size = HASHSET_MIN_SIZE;
+
+	// keep load factor below 1/2 for short probe sequences
+	while(size < 2*n_keys)
+	{
+		size <<= 1;
+	}
+
+	set->mask = size - 1;
+	set->n_entries = 0;
+	set->entries = calloc(size, sizeof(hash_entry_t));
+
+	return set->entries ? 0 : -1;
+}
+
+void
+lv2lint_hashset_deinit(hashset_t *set)
+{
+	free(set->entries);
+
+	set->mask = 0;
+	set->n_entries = 0;
+	set->entries = NULL;
+}
+
+static hash_entry_t *
+_hashset_probe(const hashset_t *set, const char *key, uint32_t hash)
+{
+	for(uint32_t i = hash & set->mask; ; i = (i + 1) & set->mask)
+	{
+		hash_entry_t *entry = &set->entries[i];
+
+		if(!entry->key
+			|| ( (entry->hash == hash) && !strcmp(entry->key, key) ) )
+		{
+			return entry;
+		}
+	}
+}
+
+hash_entry_t *
+lv2lint_hashset_insert(hashset_t *set, const char *key, uint32_t idx,
+	bool *is_new)
+{
+	// table is sized for its keys at init, never grow
+	if(2*(set->n_entries + 1) > set->mask + 1)
+	{
+		return NULL;
+	}
+
+	const uint32_t hash = lv2lint_hash(key);
+	hash_entry_t *entry = _hashset_probe(set, key, hash);
+
+	*is_new = !entry->key;
+
+	if(*is_new)
+	{
+		entry->key = key;
+		entry->hash = hash;
+		entry->idx = idx;
+
+		set->n_entries += 1;
+	}
+
+	return entry;
+}
+
+const hash_entry_t *
+lv2lint_hashset_lookup(const hashset_t *set, const char *key)
+{
+	if(!set->entries)
+	{
+		return NULL;
+	}
+
+	const hash_entry_t *entry = _hashset_probe(set, key, lv2lint_hash(key));
+
+	return entry->key ? entry : NULL;
+}
+
+char *
+lv2lint_duplicates(app_t *app, const char *const *keys, uint32_t n_keys)
+{
+	hashset_t set;
+	strbuf_t list = { .buf = NULL };
+
+	if(lv2lint_hashset_init(&set, n_keys))
+	{
+		return NULL;
+	}
+
+	for(uint32_t i = 0; i < n_keys; i++)
+	{
+		if(!keys[i])
+		{
+			continue;
+		}
+
+		bool is_new;
+		hash_entry_t *entry = lv2lint_hashset_insert(&set, keys[i], 1, &is_new);
+
+		// idx counts occurrences, list every duplicated key once
+		if(entry && !is_new && (entry->idx++ == 1) )
+		{
+			lv2lint_strbuf_printf(&list, "%s%s", list.len ? ", " : "", keys[i]);
+		}
+	}
+
+	lv2lint_hashset_deinit(&set);
+
+	char *dups = lv2lint_arena_strdup(app, list.buf);
+	lv2lint_strbuf_free(&list);
+
+	return dups;
+}
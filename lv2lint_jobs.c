@@ -0,0 +1,835 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <lv2lint.h>
+
+typedef struct _job_t job_t;
+typedef struct _worker_t worker_t;
+typedef struct _job_hdr_t job_hdr_t;
+
+struct _job_t {
+	char *buf;
+	size_t len;
+	int ret;
+	bool done;
+};
+
+struct _worker_t {
+	pid_t pid;
+	int cmd;
+	int res;
+	int busy;
+};
+
+struct _job_hdr_t {
+	uint32_t idx;
+	int32_t ret;
+	uint64_t len;
+};
+
+#define JOB_IDX_TIMINGS UINT32_MAX // final frame of a worker with its timings
+
+static int
+_write_all(int fd, const void *buf, size_t len)
+{
+	const uint8_t *ptr = buf;
+
+	while(len)
+	{
+		const ssize_t n = write(fd, ptr, len);
+
+		if(n == -1)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			return -1;
+		}
+
+		ptr += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int
+_read_all(int fd, void *buf, size_t len)
+{
+	uint8_t *ptr = buf;
+
+	while(len)
+	{
+		const ssize_t n = read(fd, ptr, len);
+
+		if(n == -1)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			return -1;
+		}
+		else if(n == 0) // EOF
+		{
+			return -1;
+		}
+
+		ptr += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static void
+_worker(app_t *app, const LilvPlugins *plugins, const char **uris, int cmd, int res)
+{
+	uint32_t idx;
+
+	// only report timings of plugins tested by this worker
+	memset(&app->timings_total, 0x0, sizeof(timings_t));
+	lv2lint_trace_process(app, "worker");
+
+	while(_read_all(cmd, &idx, sizeof(idx)) == 0)
+	{
+		job_hdr_t hdr = {
+			.idx = idx
+		};
+		FILE *out = app->out;
+		char *buf = NULL;
+		size_t len = 0;
+
+		app->out = open_memstream(&buf, &len);
+		if(!app->out)
+		{
+			app->out = out;
+			break;
+		}
+
+		hdr.ret = lv2lint_run_uri(app, plugins, uris[idx]);
+
+		fclose(app->out);
+		app->out = out;
+
+		hdr.len = len;
+
+		const int err = _write_all(res, &hdr, sizeof(hdr))
+			|| _write_all(res, buf, len);
+
+		free(buf);
+
+		if(err)
+		{
+			return;
+		}
+	}
+
+	if(app->timings)
+	{
+		const job_hdr_t hdr = {
+			.idx = JOB_IDX_TIMINGS,
+			.len = sizeof(timings_t)
+		};
+
+		if(_write_all(res, &hdr, sizeof(hdr)) == 0)
+		{
+			_write_all(res, &app->timings_total, sizeof(timings_t));
+		}
+	}
+}
+
+static const test_t test_crash = {
+	.id = "Plugin Crash"
+};
+
+static const test_t test_timeout = {
+	.id = "Plugin Timeout"
+};
+
+static const ret_t ret_crash = {
+	.lnt = LINT_FAIL,
+	.msg = "plugin crashed with signal '%s'",
+	.dsc = "The plugin process was terminated while being tested, e.g. due to\n"
+		"a segmentation fault in its instantiate, state restore or UI code."
+},
+ret_exit = {
+	.lnt = LINT_FAIL,
+	.msg = "plugin process exited prematurely with status '%s'",
+	.dsc = "The plugin process terminated itself while being tested, e.g. by\n"
+		"calling exit or abort from inside plugin or UI code."
+},
+ret_timeout = {
+	.lnt = LINT_FAIL,
+	.msg = "plugin did not finish within %s seconds",
+	.dsc = "The plugin process was killed after exceeding its time budget, e.g.\n"
+		"due to an infinite loop or a deadlock in its instantiate, state\n"
+		"restore or UI code."
+};
+
+static int64_t
+_now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (int64_t)ts.tv_sec*1000 + ts.tv_nsec/1000000;
+}
+
+static int
+_report_synthetic(app_t *app, const char *uri, const test_t *test,
+	const ret_t *ret, const char *fmt, ...)
+{
+	bool flag = true;
+	va_list args;
+
+	va_start(args, fmt);
+	res_t res = {
+		.ret = ret,
+		.urn = lv2lint_arena_vprintf(app, fmt, args),
+		.is_whitelisted = lv2lint_test_is_whitelisted(app, uri, test)
+	};
+	va_end(args);
+
+	app->plugin_uri = uri;
+	lv2lint_report(app, test, &res, LINT_PASS & app->show, &flag);
+
+	lv2lint_arena_reset(app);
+
+	app->no_cache = true; // crashes and timeouts may be sporadic
+
+	return flag ? 0 : 1;
+}
+
+static void
+_close_pipe(int *fds)
+{
+	for(unsigned i = 0; i < 2; i++)
+	{
+		if(fds[i] != -1)
+		{
+			close(fds[i]);
+		}
+	}
+}
+
+int
+lv2lint_sandbox(app_t *app, const LilvPlugins *plugins, const char *plugin_uri)
+{
+	int fds [2];
+	int tfds [2] = { -1, -1 };
+
+	fflush(app->out);
+	fflush(stdout);
+	fflush(stderr);
+
+	if(pipe(fds) == -1)
+	{
+		return lv2lint_test_uri(app, plugins, plugin_uri);
+	}
+
+	if(app->timings && (pipe(tfds) == -1) )
+	{
+		tfds[0] = -1;
+		tfds[1] = -1;
+	}
+
+	const pid_t pid = fork();
+
+	if(pid == -1)
+	{
+		close(fds[0]);
+		close(fds[1]);
+		_close_pipe(tfds);
+
+		return lv2lint_test_uri(app, plugins, plugin_uri);
+	}
+	else if(pid == 0) // child
+	{
+		close(fds[0]);
+
+		if(tfds[0] != -1)
+		{
+			close(tfds[0]);
+		}
+
+		// only report timings of this plugin back to the parent
+		memset(&app->timings_total, 0x0, sizeof(timings_t));
+		lv2lint_trace_process(app, "sandbox");
+
+		// stream line by line, so partial reports survive a crash
+		app->out = fdopen(fds[1], "w");
+		if(!app->out)
+		{
+			_exit(1);
+		}
+		setvbuf(app->out, NULL, _IOLBF, 0);
+
+		const int ret = lv2lint_test_uri(app, plugins, plugin_uri);
+
+		fclose(app->out);
+
+		if(tfds[1] != -1)
+		{
+			_write_all(tfds[1], &app->timings_total, sizeof(timings_t));
+			close(tfds[1]);
+		}
+		fflush(stdout);
+		fflush(stderr);
+		_exit(ret ? 1 : 0);
+	}
+
+	close(fds[1]);
+
+	if(tfds[1] != -1)
+	{
+		close(tfds[1]);
+	}
+
+	const int64_t deadline = _now_ms() + (int64_t)app->timeout*1000;
+	bool timed_out = false;
+	char buf [BUFSIZ];
+
+	while(true)
+	{
+		struct pollfd pfd = {
+			.fd = fds[0],
+			.events = POLLIN
+		};
+		int timeout = -1;
+
+		if(app->timeout)
+		{
+			const int64_t rem = deadline - _now_ms();
+
+			if(rem <= 0)
+			{
+				timed_out = true;
+				break;
+			}
+
+			timeout = rem;
+		}
+
+		const int n = poll(&pfd, 1, timeout);
+
+		if(n == -1)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			break;
+		}
+		else if(n == 0)
+		{
+			continue; // deadline is checked above
+		}
+
+		const ssize_t len = read(fds[0], buf, sizeof(buf));
+
+		if(len == -1)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			break;
+		}
+		else if(len == 0) // EOF
+		{
+			break;
+		}
+
+		fwrite(buf, 1, len, app->out);
+	}
+
+	close(fds[0]);
+
+	if(timed_out)
+	{
+		kill(pid, SIGKILL);
+	}
+
+	int status = 0;
+
+	while( (waitpid(pid, &status, 0) == -1) && (errno == EINTR) )
+	{
+		// retry
+	}
+
+	if(tfds[0] != -1)
+	{
+		timings_t *timings = malloc(sizeof(timings_t));
+
+		// nothing to read if the child crashed or timed out
+		if(timings && (_read_all(tfds[0], timings, sizeof(timings_t)) == 0) )
+		{
+			lv2lint_timings_merge(&app->timings_total, timings);
+		}
+
+		free(timings);
+		close(tfds[0]);
+	}
+
+	if(timed_out)
+	{
+		return _report_synthetic(app, plugin_uri, &test_timeout, &ret_timeout,
+			"%u", app->timeout);
+	}
+	else if(WIFSIGNALED(status))
+	{
+		return _report_synthetic(app, plugin_uri, &test_crash, &ret_crash,
+			"%s", strsignal(WTERMSIG(status)));
+	}
+	else if(WIFEXITED(status) && (WEXITSTATUS(status) > 1) )
+	{
+		return _report_synthetic(app, plugin_uri, &test_crash, &ret_exit,
+			"%i", WEXITSTATUS(status));
+	}
+
+	return WIFEXITED(status)
+		? WEXITSTATUS(status)
+		: 1;
+}
+
+static int
+_run_uri(app_t *app, const LilvPlugins *plugins, const char *uri)
+{
+	return app->sandbox
+		? lv2lint_sandbox(app, plugins, uri)
+		: lv2lint_test_uri(app, plugins, uri);
+}
+
+int
+lv2lint_run_uri(app_t *app, const LilvPlugins *plugins, const char *uri)
+{
+	return app->cache_dir
+		? lv2lint_cache_run(app, plugins, uri, _run_uri)
+		: _run_uri(app, plugins, uri);
+}
+
+static int
+_dispatch(worker_t *worker, unsigned *next, unsigned n_uris)
+{
+	if(*next < n_uris)
+	{
+		const uint32_t idx = *next;
+
+		if(_write_all(worker->cmd, &idx, sizeof(idx)) == 0)
+		{
+			worker->busy = idx;
+			*next += 1;
+
+			return 0;
+		}
+	}
+
+	// nothing left to do or worker is gone, let it terminate
+	close(worker->cmd);
+	worker->cmd = -1;
+	worker->busy = -1;
+
+	return -1;
+}
+
+static bool
+_reap(app_t *app, worker_t *worker, job_t *jobs, const char **uris)
+{
+	if(worker->cmd != -1)
+	{
+		close(worker->cmd);
+		worker->cmd = -1;
+	}
+
+	close(worker->res);
+	worker->res = -1;
+
+	if(worker->busy < 0)
+	{
+		return false; // worker terminated regularly
+	}
+
+	// worker died in the middle of a job, its partial report is lost
+	job_t *job = &jobs[worker->busy];
+	const char *uri = uris[worker->busy];
+	FILE *out = app->out;
+	int status = 0;
+
+	kill(worker->pid, SIGKILL); // in case it merely broke the protocol
+
+	while( (waitpid(worker->pid, &status, 0) == -1) && (errno == EINTR) )
+	{
+		// retry
+	}
+
+	worker->pid = -1;
+	worker->busy = -1;
+
+	job->ret = 1;
+	job->done = true;
+
+	app->out = open_memstream(&job->buf, &job->len);
+	if(app->out)
+	{
+		lv2lint_printf(app, "%s<%s>%s\n",
+			colors[app->atty][ANSI_COLOR_BOLD],
+			uri,
+			colors[app->atty][ANSI_COLOR_RESET]);
+
+		job->ret = WIFSIGNALED(status)
+			? _report_synthetic(app, uri, &test_crash, &ret_crash,
+				"%s", strsignal(WTERMSIG(status)))
+			: _report_synthetic(app, uri, &test_crash, &ret_exit,
+				"%i", WEXITSTATUS(status));
+
+		lv2lint_printf(app, "\n");
+
+		fclose(app->out);
+	}
+	app->out = out;
+
+	return true;
+}
+
+static int
+_spawn(app_t *app, const LilvPlugins *plugins, const char **uris,
+	worker_t *workers, unsigned n_workers, unsigned w, void (*sigpipe)(int))
+{
+	worker_t *worker = &workers[w];
+	int cmd [2];
+	int res [2];
+
+	worker->cmd = -1;
+	worker->res = -1;
+	worker->busy = -1;
+
+	// make sure buffered output is not duplicated into the worker
+	fflush(app->out);
+	fflush(stdout);
+	fflush(stderr);
+
+	if(pipe(cmd) == -1)
+	{
+		return -1;
+	}
+
+	if(pipe(res) == -1)
+	{
+		close(cmd[0]);
+		close(cmd[1]);
+		return -1;
+	}
+
+	worker->pid = fork();
+
+	if(worker->pid == 0) // worker
+	{
+		signal(SIGPIPE, sigpipe);
+
+		// close pipe ends of sibling workers
+		for(unsigned v = 0; v < n_workers; v++)
+		{
+			if(workers[v].cmd != -1)
+			{
+				close(workers[v].cmd);
+			}
+
+			if(workers[v].res != -1)
+			{
+				close(workers[v].res);
+			}
+		}
+
+		close(cmd[1]);
+		close(res[0]);
+
+		_worker(app, plugins, uris, cmd[0], res[1]);
+
+		close(cmd[0]);
+		close(res[1]);
+
+		fflush(stdout);
+		_exit(0);
+	}
+
+	close(cmd[0]);
+	close(res[1]);
+
+	if(worker->pid == -1)
+	{
+		close(cmd[1]);
+		close(res[0]);
+		return -1;
+	}
+
+	worker->cmd = cmd[1];
+	worker->res = res[0];
+
+	return 0;
+}
+
+static int
+_flush(app_t *app, job_t *jobs, unsigned *next, unsigned n_uris)
+{
+	int ret = 0;
+
+	for( ; (*next < n_uris) && jobs[*next].done; *next += 1)
+	{
+		job_t *job = &jobs[*next];
+
+		if(job->buf)
+		{
+			fwrite(job->buf, 1, job->len, app->out);
+			free(job->buf);
+			job->buf = NULL;
+		}
+
+		ret += job->ret;
+	}
+
+	fflush(app->out);
+
+	return ret;
+}
+
+int
+lv2lint_jobs(app_t *app, const LilvPlugins *plugins, const char **uris, unsigned n_uris)
+{
+	const unsigned n_workers = app->n_jobs < n_uris
+		? app->n_jobs
+		: n_uris;
+	int ret = 0;
+
+	job_t *jobs = calloc(n_uris, sizeof(job_t));
+	worker_t *workers = calloc(n_workers, sizeof(worker_t));
+	struct pollfd *fds = calloc(n_workers, sizeof(struct pollfd));
+
+	if(!jobs || !workers || !fds)
+	{
+		free(jobs);
+		free(workers);
+		free(fds);
+
+		return -1;
+	}
+
+	void (*sigpipe)(int) = signal(SIGPIPE, SIG_IGN);
+
+	unsigned n_alive = 0;
+
+	for(unsigned w = 0; w < n_workers; w++)
+	{
+		worker_t *worker = &workers[w];
+
+		worker->pid = -1;
+		worker->cmd = -1;
+		worker->res = -1;
+		worker->busy = -1;
+	}
+
+	for(unsigned w = 0; w < n_workers; w++)
+	{
+		if(_spawn(app, plugins, uris, workers, n_workers, w, sigpipe) == 0)
+		{
+			n_alive++;
+		}
+	}
+
+	unsigned next_job = 0;
+	unsigned next_print = 0;
+
+	for(unsigned w = 0; w < n_workers; w++)
+	{
+		worker_t *worker = &workers[w];
+
+		if(worker->res != -1)
+		{
+			_dispatch(worker, &next_job, n_uris);
+		}
+	}
+
+	while(n_alive)
+	{
+		unsigned n_fds = 0;
+
+		for(unsigned w = 0; w < n_workers; w++)
+		{
+			worker_t *worker = &workers[w];
+
+			if(worker->res == -1)
+			{
+				continue;
+			}
+
+			fds[n_fds].fd = worker->res;
+			fds[n_fds].events = POLLIN;
+			fds[n_fds].revents = 0;
+			n_fds++;
+		}
+
+		if(poll(fds, n_fds, -1) == -1)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			break;
+		}
+
+		for(unsigned w = 0, i = 0; w < n_workers; w++)
+		{
+			worker_t *worker = &workers[w];
+
+			if(worker->res == -1)
+			{
+				continue;
+			}
+
+			const short revents = fds[i++].revents;
+
+			if(!(revents & (POLLIN | POLLHUP | POLLERR)))
+			{
+				continue;
+			}
+
+			job_hdr_t hdr;
+			bool is_dead = false;
+
+			if(_read_all(worker->res, &hdr, sizeof(hdr)))
+			{
+				is_dead = true;
+			}
+			else if( (hdr.idx == JOB_IDX_TIMINGS) && (hdr.len == sizeof(timings_t)) )
+			{
+				timings_t *timings = malloc(sizeof(timings_t));
+
+				if(timings && (_read_all(worker->res, timings, sizeof(timings_t)) == 0) )
+				{
+					lv2lint_timings_merge(&app->timings_total, timings);
+				}
+
+				free(timings);
+				continue; // worker terminates next
+			}
+			else if(hdr.idx >= n_uris)
+			{
+				is_dead = true;
+			}
+			else
+			{
+				job_t *job = &jobs[hdr.idx];
+
+				job->buf = hdr.len ? malloc(hdr.len) : NULL;
+				job->len = hdr.len;
+
+				if(hdr.len && (!job->buf || _read_all(worker->res, job->buf, hdr.len)) )
+				{
+					free(job->buf);
+					job->buf = NULL;
+					job->len = 0;
+					is_dead = true;
+				}
+				else
+				{
+					job->ret = hdr.ret;
+					job->done = true;
+					worker->busy = -1;
+
+					_dispatch(worker, &next_job, n_uris);
+				}
+			}
+
+			if(!is_dead)
+			{
+				continue;
+			}
+
+			n_alive--;
+
+			// replace workers killed by a plugin to keep serving the queue
+			if(  _reap(app, worker, jobs, uris) && (next_job < n_uris)
+				&& (_spawn(app, plugins, uris, workers, n_workers, w, sigpipe) == 0) )
+			{
+				n_alive++;
+				_dispatch(worker, &next_job, n_uris);
+			}
+		}
+
+		ret += _flush(app, jobs, &next_print, n_uris);
+	}
+
+	// test jobs in-process which no worker was left for
+	while(next_print < n_uris)
+	{
+		job_t *job = &jobs[next_print];
+
+		if(!job->done)
+		{
+			job->ret = lv2lint_run_uri(app, plugins, uris[next_print]);
+			job->done = true;
+		}
+
+		ret += _flush(app, jobs, &next_print, n_uris);
+	}
+
+	for(unsigned w = 0; w < n_workers; w++)
+	{
+		worker_t *worker = &workers[w];
+
+		if(worker->cmd != -1)
+		{
+			close(worker->cmd);
+		}
+
+		if(worker->res != -1)
+		{
+			close(worker->res);
+		}
+
+		if(worker->pid > 0)
+		{
+			while( (waitpid(worker->pid, NULL, 0) == -1) && (errno == EINTR) )
+			{
+				// retry
+			}
+		}
+	}
+
+	signal(SIGPIPE, sigpipe);
+
+	free(jobs);
+	free(workers);
+	free(fds);
+
+	return ret;
+}
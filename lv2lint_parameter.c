@@ -427,7 +427,7 @@ _test_scale_points(app_t *app)
 {
 	static const ret_t ret_not_unique_val = {
 		.lnt = LINT_FAIL,
-		.msg = "lv2:scalePoint has not unique values",
+		.msg = "lv2:scalePoint has not unique values: %s",
 		.uri = LV2_CORE__scalePoint,
 		.dsc = "Scale point values SHOULD be unique."
 	};
@@ -437,41 +437,28 @@ _test_scale_points(app_t *app)
 		NODE(app, CORE__scalePoint), NULL);
 	if(sps)
 	{
-		LILV_FOREACH(nodes, iter1, sps)
-		{
-			const LilvNode *sp1 = lilv_nodes_get(sps, iter1);
-			LilvNode *val1 = lilv_world_get(app->world, sp1, NODE(app, RDF__value), NULL);
-			LilvNode *lbl1 = lilv_world_get(app->world, sp1, NODE(app, RDFS__label), NULL);
+		const unsigned n_sps = lilv_nodes_size(sps);
+		const char **vals = lv2lint_arena_alloc(app, n_sps * sizeof(const char *));
+		unsigned i = 0;
 
-			LILV_FOREACH(nodes, iter2, sps)
+		if(vals)
+		{
+			LILV_FOREACH(nodes, iter, sps)
 			{
-				const LilvNode *sp2 = lilv_nodes_get(sps, iter2);
+				const LilvNode *sp = lilv_nodes_get(sps, iter);
+				LilvNode *val = lilv_world_get(app->world, sp, NODE(app, RDF__value), NULL);
 
-				LilvNode *lbl2 = lilv_world_get(app->world, sp2, NODE(app, RDFS__label), NULL);
-				if(lilv_node_equals(lbl1, lbl2))
-				{
-					lilv_node_free(lbl2);
-					continue;
-				}
-				lilv_node_free(lbl2);
+				vals[i++] = lv2lint_node_as_key_strdup(app, val);
 
-				LilvNode *val2 = lilv_world_get(app->world, sp2, NODE(app, RDF__value), NULL);
-				if(lilv_node_equals(val1, val2))
-				{
-					ret = &ret_not_unique_val;
-					lilv_node_free(val2);
-					break;
-				}
-				lilv_node_free(val2);
+				lilv_node_free(val);
 			}
+		}
 
-			lilv_node_free(val1);
-			lilv_node_free(lbl1);
-
-			if(ret)
-			{
-				break;
-			}
+		char *dups = lv2lint_duplicates(app, vals, i);
+		if(dups)
+		{
+			*app->urn = dups;
+			ret = &ret_not_unique_val;
 		}
 
 		lilv_nodes_free(sps);
@@ -481,11 +468,11 @@ _test_scale_points(app_t *app)
 }
 
 static const test_t tests [] = {
-	{"Parameter Label",        _test_label},
-	{"Parameter Comment",      _test_comment},
-	{"Parameter Range",        _test_range},
-	{"Parameter Unit",         _test_unit},
-	{"Parameter Scale Points", _test_scale_points},
+	{"Parameter Label",        _test_label,        COST_META, NEEDS_NONE},
+	{"Parameter Comment",      _test_comment,      COST_META, NEEDS_NONE},
+	{"Parameter Range",        _test_range,        COST_META, NEEDS_NONE},
+	{"Parameter Unit",         _test_unit,         COST_META, NEEDS_NONE},
+	{"Parameter Scale Points", _test_scale_points, COST_META, NEEDS_NONE},
 };
 
 static const unsigned tests_n = sizeof(tests) / sizeof(test_t);
@@ -499,21 +486,7 @@ test_parameter(app_t *app)
 	if(!rets)
 		return flag;
 
-	for(unsigned i=0; i<tests_n; i++)
-	{
-		const test_t *test = &tests[i];
-		res_t *res = &rets[i];
-
-		res->is_whitelisted = lv2lint_test_is_whitelisted(app, app->plugin_uri, test);
-		res->urn = NULL;
-		app->urn = &res->urn;
-		res->ret = test->cb(app);
-		const lint_t lnt = lv2lint_extract(app, res->ret);
-		if(lnt & app->show)
-		{
-			msg = true;
-		}
-	}
+	msg = lv2lint_run_tests(app, app->plugin_uri, tests, tests_n, rets);
 
 	const bool show_passes = LINT_PASS & app->show;
 
@@ -533,12 +506,5 @@ test_parameter(app_t *app)
 		}
 	}
 
-	for(unsigned i=0; i<tests_n; i++)
-	{
-		res_t *res = &rets[i];
-
-		free(res->urn);
-	}
-
 	return flag;
 }
@@ -54,12 +54,12 @@ _test_lv2_path(app_t *app)
 
 	if(!ui_class_node)
 	{
-		*app->urn = lv2lint_strdup(lv2_path);
+		*app->urn = lv2lint_arena_strdup(app, lv2_path);
 		ret = &ret_no_ui_class;
 	}
 	else if(!plugin_class_node)
 	{
-		*app->urn = lv2lint_strdup(lv2_path);
+		*app->urn = lv2lint_arena_strdup(app, lv2_path);
 		ret = &ret_no_plugin_class;
 	}
 
@@ -125,10 +125,6 @@ _test_symbols(app_t *app)
 					*app->urn = symbols;
 					ret = &ret_symbols;
 				}
-				else if(symbols)
-				{
-					free(symbols);
-				}
 
 				lilv_free(path);
 			}
@@ -235,9 +231,43 @@ _test_linking(app_t *app)
 					*app->urn = libraries;
 					ret = &ret_libstdcpp;
 				}
-				else if(libraries)
+
+				lilv_free(path);
+			}
+		}
+	}
+
+	return ret;
+}
+
+static const ret_t *
+_test_isa_level(app_t *app)
+{
+	static const ret_t ret_isa_level = {
+		.lnt = LINT_WARN,
+		.msg = "binary requires an ISA level above the configured baseline: %s",
+		.uri = LV2_CORE__binary,
+		.dsc = "Binaries built for newer CPUs (e.g. with -march=native) crash "
+			"with illegal instructions on older ones. Build for the baseline of "
+			"the target machines and dispatch optimized code at runtime."
+	};
+
+	const ret_t *ret = NULL;
+
+	const LilvNode* node = lilv_plugin_get_library_uri(app->plugin);
+	if(node && lilv_node_is_uri(node))
+	{
+		const char *uri = lilv_node_as_uri(node);
+		if(uri)
+		{
+			char *path = lilv_file_uri_parse(uri, NULL);
+			if(path)
+			{
+				char *isa = NULL;
+				if(!test_isa_level(app, path, &isa))
 				{
-					free(libraries);
+					*app->urn = isa;
+					ret = &ret_isa_level;
 				}
 
 				lilv_free(path);
@@ -811,7 +841,7 @@ _test_class(app_t *app)
 		else if(!_test_class_match(base, class))
 		{
 			const LilvNode *class_uri = lilv_plugin_class_get_uri(class);
-			*app->urn = lv2lint_node_as_uri_strdup(class_uri);
+			*app->urn = lv2lint_node_as_uri_strdup(app, class_uri);
 			ret = &ret_class_not_valid;
 		}
 	}
@@ -848,7 +878,7 @@ _test_features(app_t *app)
 
 				if(!lilv_nodes_contains(features, node))
 				{
-					*app->urn = lv2lint_node_as_uri_strdup(node);
+					*app->urn = lv2lint_node_as_uri_strdup(app, node);
 					ret = &ret_features_not_valid;
 					break;
 				}
@@ -895,7 +925,7 @@ _test_extensions(app_t *app)
 		const void *ext = lilv_instance_get_extension_data(app->instance, uri);
 		if(ext)
 		{
-			*app->urn = lv2lint_strdup(uri);
+			*app->urn = lv2lint_arena_strdup(app, uri);
 			ret = &ret_extensions_data_not_null;
 		}
 	}
@@ -913,7 +943,7 @@ _test_extensions(app_t *app)
 
 				if(!lilv_nodes_contains(extensions, node))
 				{
-					*app->urn = lv2lint_node_as_uri_strdup(node);
+					*app->urn = lv2lint_node_as_uri_strdup(app, node);
 					ret = &ret_extensions_not_valid;
 					break;
 				}
@@ -924,7 +954,7 @@ _test_extensions(app_t *app)
 					const void *ext = lilv_instance_get_extension_data(app->instance, uri);
 					if(!ext)
 					{
-						*app->urn = lv2lint_node_as_uri_strdup(node);
+						*app->urn = lv2lint_node_as_uri_strdup(app, node);
 						ret = &ret_extensions_data_not_valid;
 						break;
 					}
@@ -984,8 +1014,8 @@ _test_worker(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	const bool has_work_schedule= lilv_plugin_has_feature(app->plugin, NODE(app, WORKER__schedule));
-	const bool has_work_iface = lilv_plugin_has_extension_data(app->plugin, NODE(app, WORKER__interface));
+	const bool has_work_schedule= app->snapshot.features[WORKER__schedule];
+	const bool has_work_iface = app->snapshot.extensions[WORKER__interface];
 
 	if(has_work_schedule || has_work_iface || app->work_iface)
 	{
@@ -1049,7 +1079,7 @@ _test_options_iface(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	const bool has_opts_iface = lilv_plugin_has_extension_data(app->plugin, NODE(app, OPTIONS__interface));
+	const bool has_opts_iface = app->snapshot.extensions[OPTIONS__interface];
 
 	if(has_opts_iface || app->opts_iface)
 	{
@@ -1100,7 +1130,7 @@ _test_options_feature(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	const bool has_opts_options= lilv_plugin_has_feature(app->plugin, NODE(app, OPTIONS__options));
+	const bool has_opts_options= app->snapshot.features[OPTIONS__options];
 	LilvNodes *required_options = lilv_plugin_get_value(app->plugin, NODE(app, OPTIONS__requiredOption));
 	LilvNodes *supported_options = lilv_plugin_get_value(app->plugin, NODE(app, OPTIONS__supportedOption));
 
@@ -1149,7 +1179,7 @@ _test_uri_map(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	if(lilv_plugin_has_feature(app->plugin, NODE(app, URI_MAP)))
+	if(app->snapshot.features[URI_MAP])
 	{
 		ret = &ret_uri_map_deprecated;
 	}
@@ -1202,11 +1232,11 @@ _test_state(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	const bool has_load_default = lilv_plugin_has_feature(app->plugin, NODE(app, STATE__loadDefaultState));
-	const bool has_thread_safe_restore = lilv_plugin_has_feature(app->plugin, NODE(app, STATE__threadSafeRestore));
+	const bool has_load_default = app->snapshot.features[STATE__loadDefaultState];
+	const bool has_thread_safe_restore = app->snapshot.features[STATE__threadSafeRestore];
 	const bool has_state = lilv_world_ask(app->world,
 		lilv_plugin_get_uri(app->plugin), NODE(app, STATE__state), NULL);
-	const bool has_iface = lilv_plugin_has_extension_data(app->plugin, NODE(app, STATE__interface));
+	const bool has_iface = app->snapshot.extensions[STATE__interface];
 
 	if(has_load_default || has_thread_safe_restore || has_state || has_iface || app->state_iface)
 	{
@@ -1368,8 +1398,8 @@ _test_idisp(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	const bool has_idisp_queue_draw = lilv_plugin_has_feature(app->plugin, NODE(app, INLINEDISPLAY__queue_draw));
-	const bool has_idisp_iface = lilv_plugin_has_extension_data(app->plugin, NODE(app, INLINEDISPLAY__interface));
+	const bool has_idisp_queue_draw = app->snapshot.features[INLINEDISPLAY__queue_draw];
+	const bool has_idisp_iface = app->snapshot.extensions[INLINEDISPLAY__interface];
 
 	if(has_idisp_queue_draw || has_idisp_iface || app->idisp_iface)
 	{
@@ -1404,15 +1434,51 @@ _test_hard_rt_capable(app_t *app)
 		.dsc = "If this plugin is meant to be used in a real-time context, you "
 			"should list this feature."
 	};
+#ifdef ENABLE_ELF_TESTS
+	static const ret_t ret_hard_rt_capable_imports = {
+		.lnt = LINT_NOTE,
+		.msg = "advertized as real-time safe, but binary imports non-real-time safe functions: %s",
+		.uri = LV2_CORE__hardRTCapable,
+		.dsc = "Functions that allocate memory, take locks, block on I/O, sleep "
+			"or enter the kernel must not be called from the audio thread. "
+			"Imports cannot tell whether they are called from run or only from "
+			"instantiate and cleanup, whitelist the latter with -s."
+	};
+#endif
 
 	const ret_t *ret = NULL;
 
-	const bool is_hard_rt_capable = lilv_plugin_has_feature(app->plugin, NODE(app, CORE__hardRTCapable));
+	const bool is_hard_rt_capable = app->snapshot.features[CORE__hardRTCapable];
 
 	if(!is_hard_rt_capable)
 	{
 		ret = &ret_hard_rt_capable_not_found;
 	}
+#ifdef ENABLE_ELF_TESTS
+	else
+	{
+		const LilvNode* node = lilv_plugin_get_library_uri(app->plugin);
+		if(node && lilv_node_is_uri(node))
+		{
+			const char *uri = lilv_node_as_uri(node);
+			if(uri)
+			{
+				char *path = lilv_file_uri_parse(uri, NULL);
+				if(path)
+				{
+					char *symbols = NULL;
+					if(!test_rt_safety(app, path, app->plugin_uri, &symbols))
+					{
+						*app->urn = symbols;
+						ret = &ret_hard_rt_capable_imports;
+					}
+
+					lilv_free(path);
+				}
+			}
+		}
+	}
+#endif
 
 	return ret;
 }
@@ -1430,7 +1496,7 @@ _test_in_place_broken(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	const bool is_in_place_broken = lilv_plugin_has_feature(app->plugin, NODE(app, CORE__inPlaceBroken));
+	const bool is_in_place_broken = app->snapshot.features[CORE__inPlaceBroken];
 
 	if(is_in_place_broken)
 	{
@@ -1453,7 +1519,7 @@ _test_is_live(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	const bool is_live = lilv_plugin_has_feature(app->plugin, NODE(app, CORE__isLive));
+	const bool is_live = app->snapshot.features[CORE__isLive];
 
 	if(!is_live)
 	{
@@ -1476,7 +1542,7 @@ _test_fixed_block_length(app_t *app)
 	const ret_t *ret = NULL;
 
 	const bool wants_fixed_block_length =
-		lilv_plugin_has_feature(app->plugin, NODE(app, BUF_SIZE__fixedBlockLength));
+		app->snapshot.features[BUF_SIZE__fixedBlockLength];
 
 	if(wants_fixed_block_length)
 	{
@@ -1499,7 +1565,7 @@ _test_power_of_2_block_length(app_t *app)
 	const ret_t *ret = NULL;
 
 	const bool wants_power_of_2_block_length =
-		lilv_plugin_has_feature(app->plugin, NODE(app, BUF_SIZE__powerOf2BlockLength));
+		app->snapshot.features[BUF_SIZE__powerOf2BlockLength];
 
 	if(wants_power_of_2_block_length)
 	{
@@ -1566,28 +1632,26 @@ _test_patch(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	const unsigned n_writables = app->writables
-		? lilv_nodes_size(app->writables) : 0;
-	const unsigned n_readables = app->readables
-		? lilv_nodes_size(app->readables) : 0;
+	const unsigned n_writables = app->snapshot.writables
+		? lilv_nodes_size(app->snapshot.writables) : 0;
+	const unsigned n_readables = app->snapshot.readables
+		? lilv_nodes_size(app->snapshot.readables) : 0;
 	const unsigned n_parameters = n_writables + n_readables;
 
 	unsigned n_patch_message_input = 0;
 	unsigned n_patch_message_output = 0;
 
-	const uint32_t num_ports = lilv_plugin_get_num_ports(app->plugin);
-	for(unsigned i=0; i<num_ports; i++)
+	for(unsigned i=0; i<app->snapshot.n_ports; i++)
 	{
-		const LilvPort *port = lilv_plugin_get_port_by_index(app->plugin, i);
+		const port_info_t *info = &app->snapshot.ports[i];
 
-		if(  lilv_port_is_a(app->plugin, port, NODE(app, ATOM__AtomPort))
-			&& lilv_port_supports_event(app->plugin, port, NODE(app, PATCH__Message)) )
+		if(info->is & PORT_IS_PATCH_MESSAGE)
 		{
-			if(lilv_port_is_a(app->plugin, port, NODE(app, CORE__InputPort)))
+			if(info->is & PORT_IS_INPUT)
 			{
 				n_patch_message_input += 1;
 			}
-			else if(lilv_port_is_a(app->plugin, port, NODE(app, CORE__OutputPort)))
+			else if(info->is & PORT_IS_OUTPUT)
 			{
 				n_patch_message_output += 1;
 			}
@@ -1614,43 +1678,48 @@ _test_patch(app_t *app)
 }
 
 static const test_t tests [] = {
-	{"Plugin LV2_PATH",        _test_lv2_path},
-	{"Plugin Instantiation",   _test_instantiation},
+	{"Plugin LV2_PATH",        _test_lv2_path,                COST_META,    NEEDS_NONE},
+	{"Plugin Instantiation",   _test_instantiation,           COST_RUNTIME, WANTS_INSTANCE},
 #ifdef ENABLE_ELF_TESTS
-	{"Plugin Symbols",         _test_symbols},
-	{"Plugin Fork",            _test_fork},
-	{"Plugin Linking",         _test_linking},
+	{"Plugin Symbols",         _test_symbols,                 COST_ELF,     NEEDS_BINARY},
+	{"Plugin Fork",            _test_fork,                    COST_ELF,     NEEDS_BINARY},
+	{"Plugin Linking",         _test_linking,                 COST_ELF,     NEEDS_BINARY},
+	{"Plugin ISA Level",       _test_isa_level,               COST_ELF,     NEEDS_BINARY},
 #endif
-	{"Plugin Verification",    _test_verification},
-	{"Plugin Name",            _test_name},
-	{"Plugin License",         _test_license},
-	{"Plugin Author Name",     _test_author_name},
-	{"Plugin Author Email",    _test_author_email},
-	{"Plugin Author Homepage", _test_author_homepage},
-	{"Plugin Version Minor",   _test_version_minor},
-	{"Plugin Version Micro",   _test_version_micro},
-	{"Plugin Project",         _test_project},
-	{"Plugin Class",           _test_class},
-	{"Plugin Features",        _test_features},
-	{"Plugin Extension Data",  _test_extensions},
-	{"Plugin Worker",          _test_worker},
-	{"Plugin Options Iface",   _test_options_iface},
-	{"Plugin Options Feature", _test_options_feature},
-	{"Plugin URI-Map",         _test_uri_map},
-	{"Plugin State",           _test_state},
-	{"Plugin Comment",         _test_comment},
-	{"Plugin Shortdesc",       _test_shortdesc},
-	{"Plugin Inline Display",  _test_idisp},
-	{"Plugin Hard RT Capable", _test_hard_rt_capable},
-	{"Plugin In Place Broken", _test_in_place_broken},
-	{"Plugin Is Live",         _test_is_live},
-	//{"Plugin Bounded Block",   _test_bounded_block_length}, //TODO check for opts:opt
-	{"Plugin Fixed Block",     _test_fixed_block_length},
-	{"Plugin PowerOf2 Block",  _test_power_of_2_block_length},
+	{"Plugin Verification",    _test_verification,            COST_META,    NEEDS_NONE},
+	{"Plugin Name",            _test_name,                    COST_META,    NEEDS_NONE},
+	{"Plugin License",         _test_license,                 COST_META,    NEEDS_NONE},
+	{"Plugin Author Name",     _test_author_name,             COST_META,    NEEDS_NONE},
+	{"Plugin Author Email",    _test_author_email,            COST_META,    NEEDS_NONE},
+	{"Plugin Author Homepage", _test_author_homepage,         COST_META,    NEEDS_NONE},
+	{"Plugin Version Minor",   _test_version_minor,           COST_META,    NEEDS_NONE},
+	{"Plugin Version Micro",   _test_version_micro,           COST_META,    NEEDS_NONE},
+	{"Plugin Project",         _test_project,                 COST_META,    NEEDS_NONE},
+	{"Plugin Class",           _test_class,                   COST_META,    NEEDS_NONE},
+	{"Plugin Features",        _test_features,                COST_META,    NEEDS_NONE},
+	{"Plugin Extension Data",  _test_extensions,              COST_RUNTIME, WANTS_INSTANCE},
+	{"Plugin Worker",          _test_worker,                  COST_RUNTIME, NEEDS_INSTANCE},
+	{"Plugin Options Iface",   _test_options_iface,           COST_RUNTIME, NEEDS_INSTANCE},
+	{"Plugin Options Feature", _test_options_feature,         COST_META,    NEEDS_NONE},
+	{"Plugin URI-Map",         _test_uri_map,                 COST_META,    NEEDS_NONE},
+	{"Plugin State",           _test_state,                   COST_RUNTIME, NEEDS_INSTANCE},
+	{"Plugin Comment",         _test_comment,                 COST_META,    NEEDS_NONE},
+	{"Plugin Shortdesc",       _test_shortdesc,               COST_META,    NEEDS_NONE},
+	{"Plugin Inline Display",  _test_idisp,                   COST_RUNTIME, NEEDS_INSTANCE},
+#ifdef ENABLE_ELF_TESTS
+	{"Plugin Hard RT Capable", _test_hard_rt_capable,         COST_ELF,     NEEDS_NONE},
+#else
+	{"Plugin Hard RT Capable", _test_hard_rt_capable,         COST_META,    NEEDS_NONE},
+#endif
+	{"Plugin In Place Broken", _test_in_place_broken,         COST_META,    NEEDS_NONE},
+	{"Plugin Is Live",         _test_is_live,                 COST_META,    NEEDS_NONE},
+	//{"Plugin Bounded Block",   _test_bounded_block_length,    COST_META,    NEEDS_NONE}, //TODO check for opts:opt
+	{"Plugin Fixed Block",     _test_fixed_block_length,      COST_META,    NEEDS_NONE},
+	{"Plugin PowerOf2 Block",  _test_power_of_2_block_length, COST_META,    NEEDS_NONE},
 #ifdef ENABLE_ONLINE_TESTS
-	{"Plugin URL",             _test_plugin_url},
+	{"Plugin URL",             _test_plugin_url,              COST_NETWORK, NEEDS_NONE},
 #endif
-	{"Plugin Patch",           _test_patch},
+	{"Plugin Patch",           _test_patch,                   COST_META,    NEEDS_NONE},
 };
 
 static const unsigned tests_n = sizeof(tests) / sizeof(test_t);
@@ -1664,25 +1733,33 @@ test_plugin(app_t *app)
 	if(!rets)
 		return flag;
 
-	app->writables = lilv_plugin_get_value(app->plugin, NODE(app, PATCH__writable));
-	app->readables = lilv_plugin_get_value(app->plugin, NODE(app, PATCH__readable));
-
-	for(unsigned i=0; i<tests_n; i++)
+	if(lv2lint_snapshot_init(app))
 	{
-		const test_t *test = &tests[i];
-		res_t *res = &rets[i];
-
-		res->is_whitelisted = lv2lint_test_is_whitelisted(app, app->plugin_uri, test);
-		res->urn = NULL;
-		app->urn = &res->urn;
-		res->ret = test->cb(app);
-		const lint_t lnt = lv2lint_extract(app, res->ret);
-		if(lnt & app->show)
-		{
-			msg = true;
-		}
+		static const test_t test_snapshot = {
+			.id = "Plugin Snapshot"
+		};
+		static const ret_t ret_snapshot = {
+			.lnt = LINT_FAIL,
+			.msg = "failed to allocate snapshot of plugin metadata, not tested",
+			.uri = LV2_CORE__Plugin,
+			.dsc = NULL
+		};
+		res_t res = {
+			.ret = &ret_snapshot
+		};
+
+		lv2lint_snapshot_deinit(app);
+
+		lv2lint_report(app, &test_snapshot, &res, LINT_PASS & app->show, &flag);
+		lv2lint_printf(app, "\n");
+
+		return false; // none of the plugin's tests could be run
 	}
 
+	const snapshot_t *snapshot = &app->snapshot;
+
+	msg = lv2lint_run_tests(app, app->plugin_uri, tests, tests_n, rets);
+
 	const bool show_passes = LINT_PASS & app->show;
 
 	if(msg || show_passes)
@@ -1696,39 +1773,38 @@ test_plugin(app_t *app)
 		}
 	}
 
-	for(unsigned i=0; i<tests_n; i++)
+	if(snapshot->n_ports < lilv_plugin_get_num_ports(app->plugin))
 	{
-		res_t *res = &rets[i];
-
-		free(res->urn);
+		flag = false; // some ports could not be retrieved
 	}
 
-	const uint32_t num_ports = lilv_plugin_get_num_ports(app->plugin);
-	for(unsigned i=0; i<num_ports; i++)
+	for(unsigned i=0; (i<snapshot->n_ports) && !app->failed_fast; i++)
 	{
 		bool port_flag = true;
 
-		app->port = lilv_plugin_get_port_by_index(app->plugin, i);
-		if(app->port)
-		{
-			if(!test_port(app))
-				port_flag = false;
-			app->port = NULL;
-		}
-		else
+		app->port_info = &snapshot->ports[i];
+		app->port = app->port_info->port;
+		if(!test_port(app))
 			port_flag = false;
+		app->port = NULL;
+		app->port_info = NULL;
 
 		if(flag && !port_flag)
 			flag = port_flag;
 	}
 
-	if(app->writables)
+	if(snapshot->writables)
 	{
-		LILV_FOREACH(nodes, itr, app->writables)
+		LILV_FOREACH(nodes, itr, snapshot->writables)
 		{
 			bool param_flag = true;
 
-			app->parameter = lilv_nodes_get(app->writables, itr);
+			if(app->failed_fast)
+			{
+				break;
+			}
+
+			app->parameter = lilv_nodes_get(snapshot->writables, itr);
 			if(app->parameter)
 			{
 				if(!test_parameter(app))
@@ -1741,18 +1817,20 @@ test_plugin(app_t *app)
 			if(flag && !param_flag)
 				flag = param_flag;
 		}
-
-		lilv_nodes_free(app->writables);
-		app->writables = NULL;
 	}
 
-	if(app->readables)
+	if(snapshot->readables)
 	{
-		LILV_FOREACH(nodes, itr, app->readables)
+		LILV_FOREACH(nodes, itr, snapshot->readables)
 		{
 			bool param_flag = true;
 
-			app->parameter = lilv_nodes_get(app->readables, itr);
+			if(app->failed_fast)
+			{
+				break;
+			}
+
+			app->parameter = lilv_nodes_get(snapshot->readables, itr);
 			if(app->parameter)
 			{
 				if(!test_parameter(app))
@@ -1765,9 +1843,6 @@ test_plugin(app_t *app)
 			if(flag && !param_flag)
 				flag = param_flag;
 		}
-
-		lilv_nodes_free(app->readables);
-		app->readables = NULL;
 	}
 
 	LilvUIs *uis = lilv_plugin_get_uis(app->plugin);
@@ -1777,6 +1852,11 @@ test_plugin(app_t *app)
 		{
 			bool ui_flag = true;
 
+			if(app->failed_fast)
+			{
+				break;
+			}
+
 			app->ui = lilv_uis_get(uis, itr);
 			if(app->ui)
 			{
@@ -1799,6 +1879,8 @@ test_plugin(app_t *app)
 		lilv_uis_free(uis);
 	}
 
+	lv2lint_snapshot_deinit(app);
+
 	lv2lint_printf(app, "\n");
 
 	return flag;
@@ -37,8 +37,7 @@ _test_class(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	LilvNodes *class = lilv_world_find_nodes(app->world,
-		NULL, NODE(app, RDFS__subClassOf), NODE(app, CORE__Port));
+	const LilvNodes *class = app->snapshot.port_classes;
 	if(class)
 	{
 		const LilvNodes *supported= lilv_port_get_classes(app->plugin, app->port);
@@ -50,14 +49,12 @@ _test_class(app_t *app)
 
 				if(!lilv_nodes_contains(class, node))
 				{
-					*app->urn = lv2lint_node_as_uri_strdup(node);
+					*app->urn = lv2lint_node_as_uri_strdup(app, node);
 					ret = &ret_class_not_valid;
 					break;
 				}
 			}
 		}
-
-		lilv_nodes_free(class);
 	}
 
 	return ret;
@@ -75,8 +72,7 @@ _test_properties(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	LilvNodes *properties = lilv_world_find_nodes(app->world,
-		NULL, NODE(app, RDF__type), NODE(app, CORE__PortProperty));
+	const LilvNodes *properties = app->snapshot.port_properties;
 	if(properties)
 	{
 		LilvNodes *supported = lilv_port_get_properties(app->plugin, app->port);
@@ -88,7 +84,7 @@ _test_properties(app_t *app)
 
 				if(!lilv_nodes_contains(properties, node))
 				{
-					*app->urn = lv2lint_node_as_uri_strdup(node);
+					*app->urn = lv2lint_node_as_uri_strdup(app, node);
 					ret = &ret_properties_not_valid;
 					break;
 				}
@@ -96,16 +92,36 @@ _test_properties(app_t *app)
 
 			lilv_nodes_free(supported);
 		}
-
-		lilv_nodes_free(properties);
 	}
 
 	return ret;
 }
 
+static inline float
+_num_value(const LilvNode *node, float fallback)
+{
+	if(node)
+	{
+		if(lilv_node_is_int(node))
+		{
+			return lilv_node_as_int(node);
+		}
+		else if(lilv_node_is_float(node))
+		{
+			return lilv_node_as_float(node);
+		}
+		else if(lilv_node_is_bool(node))
+		{
+			return lilv_node_as_bool(node) ? 1.f : 0.f;
+		}
+	}
+
+	return fallback;
+}
+
 static inline const ret_t *
-_test_num(app_t *app, LilvNode *node, bool is_integer, bool is_toggled,
-	float *val, const char *uri)
+_test_num(app_t *app, const LilvNode *node, bool is_integer, bool is_toggled,
+	const char *uri)
 {
 	static const ret_t ret_num_not_found = {
 		.lnt = LINT_WARN,
@@ -148,19 +164,6 @@ _test_num(app_t *app, LilvNode *node, bool is_integer, bool is_toggled,
 
 	if(node)
 	{
-		if(lilv_node_is_int(node))
-		{
-			*val = lilv_node_as_int(node);
-		}
-		else if(lilv_node_is_float(node))
-		{
-			*val = lilv_node_as_float(node);
-		}
-		else if(lilv_node_is_bool(node))
-		{
-			*val = lilv_node_as_bool(node) ? 1.f : 0.f;
-		}
-
 		if(is_integer)
 		{
 			if(lilv_node_is_int(node))
@@ -171,18 +174,18 @@ _test_num(app_t *app, LilvNode *node, bool is_integer, bool is_toggled,
 			{
 				if(rintf(lilv_node_as_float(node)) == lilv_node_as_float(node))
 				{
-					*app->urn = lv2lint_strdup(uri);
+					*app->urn = lv2lint_arena_strdup(app, uri);
 					ret = &ret_num_not_an_int;
 				}
 				else
 				{
-					*app->urn = lv2lint_strdup(uri);
+					*app->urn = lv2lint_arena_strdup(app, uri);
 					ret = &ret_num_not_a_whole_value;
 				}
 			}
 			else // bool
 			{
-				*app->urn = lv2lint_strdup(uri);
+				*app->urn = lv2lint_arena_strdup(app, uri);
 				ret = &ret_num_not_an_int;
 			}
 		}
@@ -192,12 +195,12 @@ _test_num(app_t *app, LilvNode *node, bool is_integer, bool is_toggled,
 			{
 				if( (lilv_node_as_int(node) == 0) || (lilv_node_as_int(node) == 1) )
 				{
-					*app->urn = lv2lint_strdup(uri);
+					*app->urn = lv2lint_arena_strdup(app, uri);
 					ret = &ret_num_not_a_bool;
 				}
 				else
 				{
-					*app->urn = lv2lint_strdup(uri);
+					*app->urn = lv2lint_arena_strdup(app, uri);
 					ret = &ret_num_not_a_boolean_value;
 				}
 			}
@@ -205,12 +208,12 @@ _test_num(app_t *app, LilvNode *node, bool is_integer, bool is_toggled,
 			{
 				if( (lilv_node_as_float(node) == 0.f) || (lilv_node_as_float(node) == 1.f) )
 				{
-					*app->urn = lv2lint_strdup(uri);
+					*app->urn = lv2lint_arena_strdup(app, uri);
 					ret = &ret_num_not_a_bool;
 				}
 				else
 				{
-					*app->urn = lv2lint_strdup(uri);
+					*app->urn = lv2lint_arena_strdup(app, uri);
 					ret = &ret_num_not_a_boolean_value;
 				}
 			}
@@ -221,15 +224,13 @@ _test_num(app_t *app, LilvNode *node, bool is_integer, bool is_toggled,
 		}
 		else if(!lilv_node_is_float(node))
 		{
-			*app->urn = lv2lint_strdup(uri);
+			*app->urn = lv2lint_arena_strdup(app, uri);
 			ret = &ret_num_not_a_float;
 		}
-
-		lilv_node_free(node);
 	}
 	else // !node
 	{
-		*app->urn = lv2lint_strdup(uri);
+		*app->urn = lv2lint_arena_strdup(app, uri);
 		ret = &ret_num_not_found;
 	}
 
@@ -241,19 +242,15 @@ _test_default(app_t *app)
 {
 	const ret_t *ret = NULL;
 
-	app->dflt.f32 = 0.f; // fall-back
-
-	const bool is_integer = lilv_port_has_property(app->plugin, app->port, NODE(app, CORE__integer));
-	const bool is_toggled = lilv_port_has_property(app->plugin, app->port, NODE(app, CORE__toggled));
+	const port_info_t *info = app->port_info;
+	const bool is_integer = info->is & PORT_IS_INTEGER;
+	const bool is_toggled = info->is & PORT_IS_TOGGLED;
 
-	if(  (lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__ControlPort))
-			|| lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__CVPort)))
-		&& lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__InputPort)) )
+	if(  (info->is & (PORT_IS_CONTROL | PORT_IS_CV))
+		&& (info->is & PORT_IS_INPUT) )
 	{
-		LilvNode *default_node = lilv_port_get(app->plugin, app->port, NODE(app, CORE__default));
-		ret = _test_num(app, default_node, is_integer, is_toggled, &app->dflt.f32,
+		ret = _test_num(app, info->dflt, is_integer, is_toggled,
 			LV2_CORE__default);
-		//lilv_node_free(default_node);
 	}
 
 	return ret;
@@ -264,20 +261,16 @@ _test_minimum(app_t *app)
 {
 	const ret_t *ret = NULL;
 
-	app->min.f32 = 0.f; // fall-back
+	const port_info_t *info = app->port_info;
+	const bool is_integer = info->is & PORT_IS_INTEGER;
+	const bool is_toggled = info->is & PORT_IS_TOGGLED;
 
-	const bool is_integer = lilv_port_has_property(app->plugin, app->port, NODE(app, CORE__integer));
-	const bool is_toggled = lilv_port_has_property(app->plugin, app->port, NODE(app, CORE__toggled));
-
-	if(  (lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__ControlPort))
-			|| lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__CVPort)))
-		&& lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__InputPort))
+	if(  (info->is & (PORT_IS_CONTROL | PORT_IS_CV))
+		&& (info->is & PORT_IS_INPUT)
 		&& !is_toggled )
 	{
-		LilvNode *minimum_node = lilv_port_get(app->plugin, app->port, NODE(app, CORE__minimum));
-		ret = _test_num(app, minimum_node, is_integer, is_toggled, &app->min.f32,
+		ret = _test_num(app, info->min, is_integer, is_toggled,
 			LV2_CORE__minimum);
-		//lilv_node_free(minimum_node);
 	}
 
 	return ret;
@@ -288,20 +281,16 @@ _test_maximum(app_t *app)
 {
 	const ret_t *ret = NULL;
 
-	app->max.f32 = 1.f; // fall-back
-
-	const bool is_integer = lilv_port_has_property(app->plugin, app->port, NODE(app, CORE__integer));
-	const bool is_toggled = lilv_port_has_property(app->plugin, app->port, NODE(app, CORE__toggled));
+	const port_info_t *info = app->port_info;
+	const bool is_integer = info->is & PORT_IS_INTEGER;
+	const bool is_toggled = info->is & PORT_IS_TOGGLED;
 
-	if(  (lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__ControlPort))
-			|| lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__CVPort)))
-		&& lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__InputPort))
+	if(  (info->is & (PORT_IS_CONTROL | PORT_IS_CV))
+		&& (info->is & PORT_IS_INPUT)
 		&& !is_toggled )
 	{
-		LilvNode *maximum_node = lilv_port_get(app->plugin, app->port, NODE(app, CORE__maximum));
-		ret = _test_num(app, maximum_node, is_integer, is_toggled, &app->max.f32,
+		ret = _test_num(app, info->max, is_integer, is_toggled,
 			LV2_CORE__maximum);
-		//lilv_node_free(maximum_node);
 	}
 
 	return ret;
@@ -319,18 +308,23 @@ _test_range(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	if(  lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__ControlPort))
-			|| lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__CVPort)) )
+	const port_info_t *info = app->port_info;
+
+	if(info->is & (PORT_IS_CONTROL | PORT_IS_CV))
 	{
-		float min = app->min.f32;
-		float max = app->max.f32;
-		if(lilv_port_has_property(app->plugin, app->port, NODE(app, CORE__sampleRate)))
+		// same fall-backs as Port Default/Minimum/Maximum, which may be deselected
+		const bool is_input = info->is & PORT_IS_INPUT;
+		const bool is_toggled = info->is & PORT_IS_TOGGLED;
+		const float dflt = is_input ? _num_value(info->dflt, 0.f) : 0.f;
+		float min = (is_input && !is_toggled) ? _num_value(info->min, 0.f) : 0.f;
+		float max = (is_input && !is_toggled) ? _num_value(info->max, 1.f) : 1.f;
+		if(info->is & PORT_IS_SAMPLE_RATE)
 		{
 			min *= 44100.0;
 			max *= 44100.0;
 		}
 
-		if( !( (min <= app->dflt.f32) && (app->dflt.f32 <= max) ) )
+		if( !( (min <= dflt) && (dflt <= max) ) )
 		{
 			ret = &ret_range;
 		}
@@ -351,10 +345,9 @@ _test_atom_port(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	if(lilv_port_is_a(app->plugin, app->port, NODE(app, ATOM__AtomPort)))
+	if(app->port_info->is & PORT_IS_ATOM)
 	{
-		const bool has_urid_map = lilv_plugin_has_feature(app->plugin,
-			NODE(app, URID__map));
+		const bool has_urid_map = app->snapshot.features[URID__map];
 
 		if(!has_urid_map)
 		{
@@ -377,7 +370,7 @@ _test_event_port(app_t *app)
 
 	const ret_t *ret = NULL;
 
-	if(lilv_port_is_a(app->plugin, app->port, NODE(app, EVENT__EventPort)))
+	if(app->port_info->is & PORT_IS_EVENT)
 	{
 		ret = &ret_event_port_deprecated;
 	}
@@ -419,22 +412,16 @@ _test_morph_port(app_t *app)
 		? lilv_nodes_size(morph_supported_types)
 		: 0;
 
-	const bool is_morph_port = lilv_port_is_a(app->plugin, app->port,
-		NODE(app, MORPH__MorphPort));
-	const bool is_auto_morph_port = lilv_port_is_a(app->plugin, app->port,
-		NODE(app, MORPH__AutoMorphPort));
+	const uint32_t is = app->port_info->is;
+	const bool is_morph_port = is & PORT_IS_MORPH;
+	const bool is_auto_morph_port = is & PORT_IS_AUTO_MORPH;
 	const bool is_any_morph_port = is_morph_port || is_auto_morph_port;
 
-	const bool is_control_port = lilv_port_is_a(app->plugin, app->port,
-		NODE(app, CORE__ControlPort));
-	const bool is_audio_port = lilv_port_is_a(app->plugin, app->port,
-		NODE(app, CORE__AudioPort));
-	const bool is_cv_port = lilv_port_is_a(app->plugin, app->port,
-		NODE(app, CORE__CVPort));
-	const bool is_atom_port = lilv_port_is_a(app->plugin, app->port,
-		NODE(app, ATOM__AtomPort));
-	const bool is_event_port = lilv_port_is_a(app->plugin, app->port,
-		NODE(app, EVENT__EventPort));
+	const bool is_control_port = is & PORT_IS_CONTROL;
+	const bool is_audio_port = is & PORT_IS_AUDIO;
+	const bool is_cv_port = is & PORT_IS_CV;
+	const bool is_atom_port = is & PORT_IS_ATOM;
+	const bool is_event_port = is & PORT_IS_EVENT;
 
 	const ret_t *ret = NULL;
 
@@ -553,8 +540,7 @@ _test_unit(app_t *app)
 	const ret_t *ret = NULL;
 
 
-	if(  lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__ControlPort))
-		|| lilv_port_is_a(app->plugin, app->port, NODE(app, CORE__CVPort)) )
+	if(app->port_info->is & (PORT_IS_CONTROL | PORT_IS_CV))
 	{
 		LilvNode *unit = lilv_port_get(app->plugin, app->port, NODE(app, UNITS__unit));
 		if(unit)
@@ -581,32 +567,30 @@ _test_symbol(app_t *app)
 {
 	static const ret_t ret_not_unique = {
 		.lnt = LINT_FAIL,
-		.msg = "lv2:symbol not unique",
+		.msg = "lv2:symbol not unique, shared with port(s) %s",
 		.uri = LV2_CORE__symbol,
 		.dsc = "Port symbols MUST be unique."
 	};
 	const ret_t *ret = NULL;
 
-	const LilvNode *symbol1 = lilv_port_get_symbol(app->plugin, app->port);
+	// ports with same symbol have been linked by lv2lint_snapshot_init
+	const port_info_t *ports = app->snapshot.ports;
+	const uint32_t self = app->port_info - ports;
 
-	const uint32_t num_ports = lilv_plugin_get_num_ports(app->plugin);
-	for(unsigned i=0; i<num_ports; i++)
+	if(ports[self].symbol_next != self)
 	{
-		const LilvPort *port = lilv_plugin_get_port_by_index(app->plugin, i);
+		strbuf_t list = { .buf = NULL };
 
-		if(port == app->port)
+		for(uint32_t i = ports[self].symbol_next; i != self; i = ports[i].symbol_next)
 		{
-			continue; // skip self
+			lv2lint_strbuf_printf(&list, "%s%u", list.len ? ", " : "",
+				(unsigned)ports[i].index);
 		}
 
-		const LilvNode *symbol2 = lilv_port_get_symbol(app->plugin, port);
-
-		if(lilv_node_equals(symbol1, symbol2))
-		{
-			ret = &ret_not_unique;
+		*app->urn = lv2lint_arena_strdup(app, list.buf);
+		lv2lint_strbuf_free(&list);
 
-			break;
-		}
+		ret = &ret_not_unique;
 	}
 
 	return ret;
@@ -617,13 +601,13 @@ _test_scale_points(app_t *app)
 {
 	static const ret_t ret_not_unique_val = {
 		.lnt = LINT_FAIL,
-		.msg = "lv2:scalePoint has not unique values",
+		.msg = "lv2:scalePoint has not unique values: %s",
 		.uri = LV2_CORE__scalePoint,
 		.dsc = "Scale point values SHOULD be unique."
 	},
 	ret_not_unique_lbl = {
 		.lnt = LINT_WARN,
-		.msg = "lv2:scalePoint has not unique labels",
+		.msg = "lv2:scalePoint has not unique labels: %s",
 		.uri = LV2_CORE__scalePoint,
 		.dsc = "Scale point labels SHOULD be unique."
 	};
@@ -632,40 +616,35 @@ _test_scale_points(app_t *app)
 	LilvScalePoints *sps = lilv_port_get_scale_points(app->plugin, app->port);
 	if(sps)
 	{
-		LILV_FOREACH(scale_points, iter1, sps)
-		{
-			const LilvScalePoint *sp1 = lilv_scale_points_get(sps, iter1);
-			const LilvNode *val1 = lilv_scale_point_get_value(sp1);
-			const LilvNode *lbl1 = lilv_scale_point_get_label(sp1);
+		const unsigned n_sps = lilv_scale_points_size(sps);
+		const char **vals = lv2lint_arena_alloc(app, n_sps * sizeof(const char *));
+		const char **lbls = lv2lint_arena_alloc(app, n_sps * sizeof(const char *));
+		unsigned i = 0;
 
-			LILV_FOREACH(scale_points, iter2, sps)
+		if(vals && lbls)
+		{
+			LILV_FOREACH(scale_points, iter, sps)
 			{
-				const LilvScalePoint *sp2 = lilv_scale_points_get(sps, iter2);
-
-				if(sp1 == sp2)
-				{
-					continue; // ignore self
-				}
-
-				const LilvNode *val2 = lilv_scale_point_get_value(sp2);
-				if(lilv_node_equals(val1, val2))
-				{
-					ret = &ret_not_unique_val;
-					break;
-				}
+				const LilvScalePoint *sp = lilv_scale_points_get(sps, iter);
+				const LilvNode *lbl = lilv_scale_point_get_label(sp);
 
-				const LilvNode *lbl2 = lilv_scale_point_get_label(sp2);
-				if(lilv_node_equals(lbl1, lbl2))
-				{
-					ret = &ret_not_unique_lbl;
-					break;
-				}
+				vals[i] = lv2lint_node_as_key_strdup(app, lilv_scale_point_get_value(sp));
+				lbls[i] = lbl ? lilv_node_as_string(lbl) : NULL;
+				i++;
 			}
+		}
 
-			if(ret)
-			{
-				break;
-			}
+		char *dups = NULL;
+
+		if( (dups = lv2lint_duplicates(app, vals, i)) )
+		{
+			*app->urn = dups;
+			ret = &ret_not_unique_val;
+		}
+		else if( (dups = lv2lint_duplicates(app, lbls, i)) )
+		{
+			*app->urn = dups;
+			ret = &ret_not_unique_lbl;
 		}
 
 		lilv_scale_points_free(sps);
@@ -675,20 +654,20 @@ _test_scale_points(app_t *app)
 }
 
 static const test_t tests [] = {
-	{"Port Class",          _test_class},
-	{"Port Properties",     _test_properties},
-	{"Port Default",        _test_default},
-	{"Port Minimum",        _test_minimum},
-	{"Port Maximum",        _test_maximum},
-	{"Port Range",          _test_range},
-	{"Port Event Port",     _test_event_port},
-	{"Port Atom Port",      _test_atom_port},
-	{"Port Morph Port",     _test_morph_port},
-	{"Port Comment",        _test_comment},
-	{"Port Group",          _test_group},
-	{"Port Units",          _test_unit},
-	{"Port Symbol",         _test_symbol},
-	{"Port Scale Points",   _test_scale_points},
+	{"Port Class",          _test_class,        COST_META, NEEDS_NONE},
+	{"Port Properties",     _test_properties,   COST_META, NEEDS_NONE},
+	{"Port Default",        _test_default,      COST_META, NEEDS_NONE},
+	{"Port Minimum",        _test_minimum,      COST_META, NEEDS_NONE},
+	{"Port Maximum",        _test_maximum,      COST_META, NEEDS_NONE},
+	{"Port Range",          _test_range,        COST_META, NEEDS_NONE},
+	{"Port Event Port",     _test_event_port,   COST_META, NEEDS_NONE},
+	{"Port Atom Port",      _test_atom_port,    COST_META, NEEDS_NONE},
+	{"Port Morph Port",     _test_morph_port,   COST_META, NEEDS_NONE},
+	{"Port Comment",        _test_comment,      COST_META, NEEDS_NONE},
+	{"Port Group",          _test_group,        COST_META, NEEDS_NONE},
+	{"Port Units",          _test_unit,         COST_META, NEEDS_NONE},
+	{"Port Symbol",         _test_symbol,       COST_META, NEEDS_NONE},
+	{"Port Scale Points",   _test_scale_points, COST_META, NEEDS_NONE},
 };
 
 static const unsigned tests_n = sizeof(tests) / sizeof(test_t);
@@ -702,21 +681,7 @@ test_port(app_t *app)
 	if(!rets)
 		return flag;
 
-	for(unsigned i=0; i<tests_n; i++)
-	{
-		const test_t *test = &tests[i];
-		res_t *res = &rets[i];
-
-		res->is_whitelisted = lv2lint_test_is_whitelisted(app, app->plugin_uri, test);
-		res->urn = NULL;
-		app->urn = &res->urn;
-		res->ret = test->cb(app);
-		const lint_t lnt = lv2lint_extract(app, res->ret);
-		if(lnt & app->show)
-		{
-			msg = true;
-		}
-	}
+	msg = lv2lint_run_tests(app, app->plugin_uri, tests, tests_n, rets);
 
 	const bool show_passes = LINT_PASS & app->show;
 
@@ -724,8 +689,8 @@ test_port(app_t *app)
 	{
 		lv2lint_printf(app, "  %s{%d : %s}%s\n",
 			colors[app->atty][ANSI_COLOR_BOLD],
-			lilv_port_get_index(app->plugin, app->port),
-			lilv_node_as_string(lilv_port_get_symbol(app->plugin, app->port)),
+			app->port_info->index,
+			lilv_node_as_string(app->port_info->symbol),
 			colors[app->atty][ANSI_COLOR_RESET]);
 
 		for(unsigned i=0; i<tests_n; i++)
@@ -737,12 +702,5 @@ test_port(app_t *app)
 		}
 	}
 
-	for(unsigned i=0; i<tests_n; i++)
-	{
-		res_t *res = &rets[i];
-
-		free(res->urn);
-	}
-
 	return flag;
 }
@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <lv2lint.h>
+
+/*
+ * Protocol
+ *
+ * client -> server: req_hdr_t, cwd, argv[0..argc-1], each as uint32_t
+ *                   length followed by the string without terminating zero
+ * server -> client: a sequence of frame_t, FRAME_DATA with report output as
+ *                   payload, terminated by FRAME_END with int32_t return code
+ */
+
+#define PROTO_MAGIC 0x4c56324cU // 'LV2L'
+#define MAX_STRING_LEN 0x10000
+#define MAX_ARGC 0x10000
+
+typedef struct _req_hdr_t req_hdr_t;
+typedef struct _frame_t frame_t;
+
+typedef enum _frame_type_t {
+	FRAME_DATA,
+	FRAME_END
+} frame_type_t;
+
+struct _req_hdr_t {
+	uint32_t magic;
+	int32_t atty;
+	uint32_t argc;
+};
+
+struct _frame_t {
+	uint32_t type;
+	uint32_t len;
+};
+
+static volatile sig_atomic_t done = 0;
+
+static void
+_sig(int sig __unused)
+{
+	done = 1;
+}
+
+static int
+_send(int fd, const void *buf, size_t len)
+{
+	const uint8_t *ptr = buf;
+
+	while(len)
+	{
+		const ssize_t n = send(fd, ptr, len, MSG_NOSIGNAL);
+
+		if(n == -1)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			return -1;
+		}
+
+		ptr += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int
+_recv(int fd, void *buf, size_t len)
+{
+	uint8_t *ptr = buf;
+
+	while(len)
+	{
+		const ssize_t n = recv(fd, ptr, len, 0);
+
+		if(n == -1)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			return -1;
+		}
+		else if(n == 0) // peer hung up
+		{
+			return -1;
+		}
+
+		ptr += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int
+_send_string(int fd, const char *str)
+{
+	const uint32_t len = strlen(str);
+
+	return _send(fd, &len, sizeof(len)) || _send(fd, str, len);
+}
+
+static char *
+_recv_string(int fd)
+{
+	uint32_t len;
+
+	if(_recv(fd, &len, sizeof(len)) || (len > MAX_STRING_LEN) )
+	{
+		return NULL;
+	}
+
+	char *str = malloc(len + 1);
+	if(!str)
+	{
+		return NULL;
+	}
+
+	if(_recv(fd, str, len))
+	{
+		free(str);
+		return NULL;
+	}
+
+	str[len] = '\0';
+
+	return str;
+}
+
+static int
+_send_frame(int fd, frame_type_t type, const void *buf, uint32_t len)
+{
+	const frame_t frame = {
+		.type = type,
+		.len = len
+	};
+
+	return _send(fd, &frame, sizeof(frame)) || (len && _send(fd, buf, len));
+}
+
+static ssize_t
+_cookie_write(void *data, const char *buf, size_t size)
+{
+	const int *fd = data;
+
+	if(_send_frame(*fd, FRAME_DATA, buf, size))
+	{
+		return -1;
+	}
+
+	return size;
+}
+
+static void
+_serve(app_t *app, int fd)
+{
+	req_hdr_t hdr;
+	char *cwd = NULL;
+	char **argv = NULL;
+	int32_t ret = -1;
+
+	if(  _recv(fd, &hdr, sizeof(hdr))
+		|| (hdr.magic != PROTO_MAGIC)
+		|| (hdr.argc < 1)
+		|| (hdr.argc > MAX_ARGC)
+		|| !(cwd = _recv_string(fd))
+		|| !(argv = calloc(hdr.argc + 1, sizeof(char *))) )
+	{
+		free(cwd);
+		return;
+	}
+
+	for(uint32_t i = 0; i < hdr.argc; i++)
+	{
+		if(!(argv[i] = _recv_string(fd)))
+		{
+			goto fail;
+		}
+	}
+
+	// resolve relative include directories like the client would
+	if(chdir(cwd) == -1)
+	{
+		goto fail;
+	}
+
+	static const cookie_io_functions_t io = {
+		.write = _cookie_write
+	};
+
+	FILE *out = fopencookie(&fd, "w", io);
+	if(!out)
+	{
+		goto fail;
+	}
+
+	app->out = out;
+	app->atty = hdr.atty;
+
+	ret = lv2lint_request(app, hdr.argc, argv);
+
+	fclose(out);
+	app->out = stdout;
+
+fail:
+	_send_frame(fd, FRAME_END, &ret, sizeof(ret));
+
+	for(uint32_t i = 0; i < hdr.argc; i++)
+	{
+		free(argv[i]);
+	}
+
+	free(argv);
+	free(cwd);
+}
+
+static int
+_addr(struct sockaddr_un *addr, const char *path)
+{
+	memset(addr, 0x0, sizeof(struct sockaddr_un));
+
+	addr->sun_family = AF_UNIX;
+
+	if(strlen(path) >= sizeof(addr->sun_path))
+	{
+		fprintf(stderr, "Socket path `%s' is too long.\n", path);
+		return -1;
+	}
+
+	strncpy(addr->sun_path, path, sizeof(addr->sun_path) - 1);
+
+	return 0;
+}
+
+int
+lv2lint_server(app_t *app, const char *path)
+{
+	struct sockaddr_un addr;
+
+	if(_addr(&addr, path))
+	{
+		return -1;
+	}
+
+	const int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(sock == -1)
+	{
+		return -1;
+	}
+
+	unlink(path); // remove stale socket
+
+	if(  (bind(sock, (const struct sockaddr *)&addr, sizeof(addr)) == -1)
+		|| (listen(sock, 16) == -1) )
+	{
+		fprintf(stderr, "Failed to listen on `%s': %s.\n", path, strerror(errno));
+		close(sock);
+		return -1;
+	}
+
+	// no SA_RESTART, so accept is interrupted on termination
+	const struct sigaction sa = {
+		.sa_handler = _sig
+	};
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	fflush(stdout);
+	fflush(stderr);
+
+	while(!done)
+	{
+		const int fd = accept(sock, NULL, NULL);
+
+		// reap finished request handlers
+		while(waitpid(-1, NULL, WNOHANG) > 0)
+		{
+			// continue
+		}
+
+		if(fd == -1)
+		{
+			continue;
+		}
+
+		const pid_t pid = fork();
+
+		if(pid == 0) // handle request on a copy-on-write copy of the warm world
+		{
+			signal(SIGINT, SIG_DFL);
+			signal(SIGTERM, SIG_DFL);
+			close(sock);
+
+			_serve(app, fd);
+
+			close(fd);
+			fflush(stdout);
+			fflush(stderr);
+			_exit(0);
+		}
+
+		close(fd);
+	}
+
+	close(sock);
+	unlink(path);
+
+	while(waitpid(-1, NULL, 0) > 0)
+	{
+		// continue
+	}
+
+	return 0;
+}
+
+int
+lv2lint_client(app_t *app, const char *path, int argc, char **argv)
+{
+	struct sockaddr_un addr;
+	char *cwd = getcwd(NULL, 0);
+	int32_t ret = -1;
+
+	if(!cwd || _addr(&addr, path))
+	{
+		free(cwd);
+		return -1;
+	}
+
+	const int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(sock == -1)
+	{
+		free(cwd);
+		return -1;
+	}
+
+	if(connect(sock, (const struct sockaddr *)&addr, sizeof(addr)) == -1)
+	{
+		fprintf(stderr, "Failed to connect to `%s': %s.\n", path, strerror(errno));
+		close(sock);
+		free(cwd);
+		return -1;
+	}
+
+	const req_hdr_t hdr = {
+		.magic = PROTO_MAGIC,
+		.atty = app->atty,
+		.argc = argc
+	};
+
+	bool failed = _send(sock, &hdr, sizeof(hdr)) || _send_string(sock, cwd);
+
+	for(int i = 0; !failed && (i < argc); i++)
+	{
+		failed = _send_string(sock, argv[i]);
+	}
+
+	free(cwd);
+
+	while(!failed)
+	{
+		frame_t frame;
+
+		if(_recv(sock, &frame, sizeof(frame)))
+		{
+			fprintf(stderr, "Server `%s' hung up prematurely.\n", path);
+			ret = -1;
+			break;
+		}
+
+		if(frame.type == FRAME_END)
+		{
+			if( (frame.len != sizeof(ret)) || _recv(sock, &ret, sizeof(ret)) )
+			{
+				ret = -1;
+			}
+
+			break;
+		}
+
+		char buf [BUFSIZ];
+
+		for(uint32_t len = frame.len; len; )
+		{
+			const uint32_t n = len < sizeof(buf)
+				? len
+				: sizeof(buf);
+
+			if(_recv(sock, buf, n))
+			{
+				failed = true;
+				break;
+			}
+
+			fwrite(buf, 1, n, stdout);
+			len -= n;
+		}
+	}
+
+	close(sock);
+
+	return ret;
+}
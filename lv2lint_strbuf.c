@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+
+#include <lv2lint.h>
+
+#define STRBUF_MIN_CAP 256
+
+int
+lv2lint_strbuf_reserve(strbuf_t *sb, size_t len)
+{
+	const size_t needed = sb->len + len + 1; // terminating zero
+
+	if(needed <= sb->cap)
+	{
+		return 0;
+	}
+
+	size_t cap = sb->cap ? sb->cap : STRBUF_MIN_CAP;
+
+	while(cap < needed)
+	{
+		cap *= 2;
+	}
+
+	char *buf = realloc(sb->buf, cap);
+	if(!buf)
+	{
+		return -1;
+	}
+
+	sb->buf = buf;
+	sb->buf[sb->len] = '\0';
+	sb->cap = cap;
+
+	return 0;
+}
+
+int
+lv2lint_strbuf_append(strbuf_t *sb, const char *str, size_t len)
+{
+	if(lv2lint_strbuf_reserve(sb, len))
+	{
+		return -1;
+	}
+
+	memcpy(sb->buf + sb->len, str, len);
+	sb->len += len;
+	sb->buf[sb->len] = '\0';
+
+	return 0;
+}
+
+int
+lv2lint_strbuf_puts(strbuf_t *sb, const char *str)
+{
+	return lv2lint_strbuf_append(sb, str, strlen(str));
+}
+
+int
+lv2lint_strbuf_putc(strbuf_t *sb, char c)
+{
+	return lv2lint_strbuf_append(sb, &c, 1);
+}
+
+int
+lv2lint_strbuf_vprintf(strbuf_t *sb, const char *fmt, va_list args)
+{
+	va_list args2;
+
+	va_copy(args2, args);
+	const int len = vsnprintf(sb->buf ? sb->buf + sb->len : NULL,
+		sb->buf ? sb->cap - sb->len : 0, fmt, args2);
+	va_end(args2);
+
+	if(len < 0)
+	{
+		return -1;
+	}
+
+	if(sb->buf && (sb->len + len < sb->cap) ) // did fit
+	{
+		sb->len += len;
+		return 0;
+	}
+
+	if(lv2lint_strbuf_reserve(sb, len))
+	{
+		if(sb->buf)
+		{
+			sb->buf[sb->len] = '\0'; // drop truncated output
+		}
+
+		return -1;
+	}
+
+	vsnprintf(sb->buf + sb->len, sb->cap - sb->len, fmt, args);
+	sb->len += len;
+
+	return 0;
+}
+
+int
+lv2lint_strbuf_printf(strbuf_t *sb, const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+
+	const int ret = lv2lint_strbuf_vprintf(sb, fmt, args);
+
+	va_end(args);
+
+	return ret;
+}
+
+void
+lv2lint_strbuf_reset(strbuf_t *sb)
+{
+	sb->len = 0;
+
+	if(sb->buf)
+	{
+		sb->buf[0] = '\0';
+	}
+}
+
+char *
+lv2lint_strbuf_steal(strbuf_t *sb)
+{
+	char *buf = sb->buf;
+
+	sb->buf = NULL;
+	sb->len = 0;
+	sb->cap = 0;
+
+	return buf;
+}
+
+void
+lv2lint_strbuf_free(strbuf_t *sb)
+{
+	free(lv2lint_strbuf_steal(sb));
+}
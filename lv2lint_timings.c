@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include <lv2lint.h>
+
+static const char *kind_labels [TIMING_KIND_MAX] = {
+	[TIMING_PHASE] = "phase",
+	[TIMING_TEST] = "test"
+};
+
+static inline bool
+_is_timing(app_t *app)
+{
+	return app->timings || (app->trace_fd != -1);
+}
+
+uint64_t
+lv2lint_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+
+static void
+_timings_add(timings_t *timings, timing_kind_t kind, const char *id,
+	uint64_t count, uint64_t ns, uint64_t max_ns)
+{
+	timing_t *timing = NULL;
+
+	for(unsigned i = 0; i < timings->n_timings; i++)
+	{
+		timing_t *tmp = &timings->timings[i];
+
+		// ids are string literals, compare by address first
+		if( (tmp->kind == kind) && ((tmp->id == id) || !strcmp(tmp->id, id)) )
+		{
+			timing = tmp;
+			break;
+		}
+	}
+
+	if(!timing)
+	{
+		if(timings->n_timings >= MAX_TIMINGS)
+		{
+			return;
+		}
+
+		timing = &timings->timings[timings->n_timings++];
+		timing->kind = kind;
+		timing->id = id;
+		timing->count = 0;
+		timing->ns = 0;
+		timing->max_ns = 0;
+	}
+
+	timing->count += count;
+	timing->ns += ns;
+
+	if(max_ns > timing->max_ns)
+	{
+		timing->max_ns = max_ns;
+	}
+}
+
+static void
+_slowest_add(timings_t *timings, const char *uri, uint64_t ns)
+{
+	unsigned pos = timings->n_slowest;
+
+	while( (pos > 0) && (timings->slowest[pos - 1].ns < ns) )
+	{
+		pos--;
+	}
+
+	if(pos >= MAX_SLOWEST)
+	{
+		return;
+	}
+
+	const unsigned n = timings->n_slowest < MAX_SLOWEST
+		? timings->n_slowest + 1
+		: MAX_SLOWEST;
+
+	memmove(&timings->slowest[pos + 1], &timings->slowest[pos],
+		(n - pos - 1) * sizeof(slowest_t));
+
+	slowest_t *slowest = &timings->slowest[pos];
+	slowest->ns = ns;
+	snprintf(slowest->uri, sizeof(slowest->uri), "%s", uri);
+
+	timings->n_slowest = n;
+}
+
+void
+lv2lint_timing(app_t *app, timing_kind_t kind, const char *id, uint64_t t0)
+{
+	if(!_is_timing(app))
+	{
+		return;
+	}
+
+	const uint64_t t1 = lv2lint_now();
+	const uint64_t ns = t1 - t0;
+
+	lv2lint_trace_event(app, kind_labels[kind], id, t0, t1);
+
+	if(app->timings)
+	{
+		_timings_add(&app->timings_plugin, kind, id, 1, ns, ns);
+		_timings_add(&app->timings_total, kind, id, 1, ns, ns);
+	}
+}
+
+const ret_t *
+lv2lint_run_test(app_t *app, const test_t *test)
+{
+	if(!_is_timing(app))
+	{
+		return test->cb(app);
+	}
+
+	const uint64_t t0 = lv2lint_now();
+
+	app->test_id = test->id; // tag nested phases with their test
+	const ret_t *ret = test->cb(app);
+	app->test_id = NULL;
+
+	lv2lint_timing(app, TIMING_TEST, test->id, t0);
+
+	return ret;
+}
+
+void
+lv2lint_timings_merge(timings_t *dst, const timings_t *src)
+{
+	for(unsigned i = 0; i < src->n_timings; i++)
+	{
+		const timing_t *timing = &src->timings[i];
+
+		_timings_add(dst, timing->kind, timing->id, timing->count, timing->ns,
+			timing->max_ns);
+	}
+
+	for(unsigned i = 0; i < src->n_slowest; i++)
+	{
+		const slowest_t *slowest = &src->slowest[i];
+
+		_slowest_add(dst, slowest->uri, slowest->ns);
+	}
+
+	dst->n_plugins += src->n_plugins;
+	dst->ns += src->ns;
+}
+
+static int
+_timing_cmp(const void *a, const void *b)
+{
+	const timing_t *timing_a = a;
+	const timing_t *timing_b = b;
+
+	if(timing_a->ns == timing_b->ns)
+	{
+		return 0;
+	}
+
+	return timing_a->ns < timing_b->ns ? 1 : -1;
+}
+
+static void
+_timings_print(app_t *app, timings_t *timings, bool aggregate)
+{
+	qsort(timings->timings, timings->n_timings, sizeof(timing_t), _timing_cmp);
+
+	for(unsigned i = 0; i < timings->n_timings; i++)
+	{
+		const timing_t *timing = &timings->timings[i];
+
+		lv2lint_printf(app, "              %-5s  %-28s %10.3f ms",
+			kind_labels[timing->kind], timing->id, timing->ns * 1e-6);
+
+		if(aggregate || (timing->count > 1) )
+		{
+			lv2lint_printf(app, "  (%"PRIu64"x, max %.3f ms)",
+				timing->count, timing->max_ns * 1e-6);
+		}
+
+		lv2lint_printf(app, "\n");
+	}
+}
+
+void
+lv2lint_timings_plugin(app_t *app, const char *uri, uint64_t t0)
+{
+	if(!_is_timing(app))
+	{
+		return;
+	}
+
+	const uint64_t t1 = lv2lint_now();
+	const uint64_t ns = t1 - t0;
+	timings_t *timings = &app->timings_plugin;
+
+	lv2lint_trace_event(app, "plugin", uri, t0, t1);
+
+	if(!app->timings)
+	{
+		return;
+	}
+
+	_slowest_add(&app->timings_total, uri, ns);
+	app->timings_total.n_plugins += 1;
+	app->timings_total.ns += ns;
+
+	lv2lint_printf(app, "    [%sTIME%s]  %.3f ms\n",
+		colors[app->atty][ANSI_COLOR_BLUE], colors[app->atty][ANSI_COLOR_RESET],
+		ns * 1e-6);
+
+	_timings_print(app, timings, false);
+
+	memset(timings, 0x0, sizeof(timings_t));
+}
+
+void
+lv2lint_timings_total(app_t *app)
+{
+	if(!app->timings)
+	{
+		return;
+	}
+
+	timings_t *timings = &app->timings_total;
+
+	lv2lint_printf(app, "%stimings%s  %.3f ms over %u plugin(s)\n",
+		colors[app->atty][ANSI_COLOR_BOLD], colors[app->atty][ANSI_COLOR_RESET],
+		timings->ns * 1e-6, timings->n_plugins);
+
+	_timings_print(app, timings, true);
+
+	if(timings->n_slowest)
+	{
+		lv2lint_printf(app, "          slowest plugins\n");
+	}
+
+	for(unsigned i = 0; i < timings->n_slowest; i++)
+	{
+		const slowest_t *slowest = &timings->slowest[i];
+
+		lv2lint_printf(app, "              %10.3f ms  <%s>\n",
+			slowest->ns * 1e-6, slowest->uri);
+	}
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+
+#include <lv2lint.h>
+
+/*
+ * Chrome trace-event JSON array format, one event per line
+ *
+ * The file is opened with O_APPEND and shared by forked workers and sandboxes,
+ * every event is written with a single write, so lines never interleave.
+ */
+
+static int
+_write_line(app_t *app, const char *line, size_t len)
+{
+	while(true)
+	{
+		const ssize_t n = write(app->trace_fd, line, len);
+
+		if( (n == -1) && (errno == EINTR) )
+		{
+			continue;
+		}
+
+		return (n == (ssize_t)len) ? 0 : -1;
+	}
+}
+
+static char *
+_escape(const char *str)
+{
+	if(!str)
+	{
+		return lv2lint_strdup("");
+	}
+
+	char *esc = malloc(strlen(str)*6 + 1); // worst case \u00XX
+	if(!esc)
+	{
+		return NULL;
+	}
+
+	char *dst = esc;
+
+	for(const char *src = str; *src; src++)
+	{
+		const unsigned char c = *src;
+
+		if( (c == '"') || (c == '\\') )
+		{
+			*dst++ = '\\';
+			*dst++ = c;
+		}
+		else if(c < 0x20)
+		{
+			dst += sprintf(dst, "\\u%04x", c);
+		}
+		else
+		{
+			*dst++ = c;
+		}
+	}
+
+	*dst = '\0';
+
+	return esc;
+}
+
+int
+lv2lint_trace_open(app_t *app, const char *path)
+{
+	app->trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+		0644);
+
+	if(app->trace_fd == -1)
+	{
+		fprintf(stderr, "Failed to open trace file `%s': %s.\n", path, strerror(errno));
+		return -1;
+	}
+
+	static const char head [] = "[\n";
+
+	return _write_line(app, head, sizeof(head) - 1);
+}
+
+void
+lv2lint_trace_close(app_t *app)
+{
+	if(app->trace_fd == -1)
+	{
+		return;
+	}
+
+	char *line = NULL;
+	const int len = asprintf(&line,
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%i,\"tid\":%i,"
+		"\"args\":{\"name\":\"lv2lint\"}}\n]\n",
+		getpid(), getpid());
+
+	if(len != -1)
+	{
+		_write_line(app, line, len);
+		free(line);
+	}
+
+	close(app->trace_fd);
+	app->trace_fd = -1;
+}
+
+void
+lv2lint_trace_process(app_t *app, const char *name)
+{
+	if(app->trace_fd == -1)
+	{
+		return;
+	}
+
+	char *line = NULL;
+	const int len = asprintf(&line,
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%i,\"tid\":%i,"
+		"\"args\":{\"name\":\"%s\"}},\n",
+		getpid(), getpid(), name);
+
+	if(len != -1)
+	{
+		_write_line(app, line, len);
+		free(line);
+	}
+}
+
+void
+lv2lint_trace_event(app_t *app, const char *cat, const char *name,
+	uint64_t t0, uint64_t t1)
+{
+	if(app->trace_fd == -1)
+	{
+		return;
+	}
+
+	char *name_esc = _escape(name);
+	char *uri_esc = _escape(app->plugin_uri);
+	char *test_esc = _escape(app->test_id);
+	char *line = NULL;
+	int len = -1;
+
+	if(name_esc && uri_esc && test_esc)
+	{
+		len = asprintf(&line,
+			"{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%"PRIu64".%03u,"
+			"\"dur\":%"PRIu64".%03u,\"pid\":%i,\"tid\":%i,"
+			"\"args\":{\"uri\":\"%s\",\"test\":\"%s\"}},\n",
+			name_esc, cat, t0 / 1000, (unsigned)(t0 % 1000),
+			(t1 - t0) / 1000, (unsigned)((t1 - t0) % 1000),
+			getpid(), getpid(), uri_esc, test_esc);
+	}
+
+	if(len != -1)
+	{
+		_write_line(app, line, len);
+		free(line);
+	}
+
+	free(name_esc);
+	free(uri_esc);
+	free(test_esc);
+}
@@ -65,10 +65,6 @@ _test_symbols(app_t *app)
 					*app->urn = symbols;
 					ret = &ret_symbols;
 				}
-				else if(symbols)
-				{
-					free(symbols);
-				}
 
 				lilv_free(path);
 			}
@@ -260,7 +256,7 @@ _test_extension_data(app_t *app)
 			: NULL;
 		if(ext)
 		{
-			*app->urn = lv2lint_strdup(uri);
+			*app->urn = lv2lint_arena_strdup(app, uri);
 			ret = &ret_extensions_data_not_null;
 		}
 	}
@@ -462,7 +458,7 @@ _test_toolkit(app_t *app)
 	}
 	else if(!is_known)
 	{
-		*app->urn = lv2lint_node_as_uri_strdup(ui_class_node);
+		*app->urn = lv2lint_node_as_uri_strdup(app, ui_class_node);
 		ret = &ret_toolkit_unknown;
 	}
 	else if(is_external)
@@ -475,7 +471,7 @@ _test_toolkit(app_t *app)
 	}
 	else if(!is_native)
 	{
-		*app->urn = lv2lint_node_as_uri_strdup(ui_class_node);
+		*app->urn = lv2lint_node_as_uri_strdup(app, ui_class_node);
 		ret = &ret_toolkit_non_native;
 	}
 
@@ -519,21 +515,21 @@ _test_ui_url(app_t *app)
 
 static const test_t tests [] = {
 #ifdef ENABLE_ELF_TESTS
-	{"UI Symbols",          _test_symbols},
-	{"UI Fork",             _test_fork},
+	{"UI Symbols",          _test_symbols,          COST_ELF,     NEEDS_BINARY},
+	{"UI Fork",             _test_fork,             COST_ELF,     NEEDS_BINARY},
 #endif
-	{"UI Instance Access",  _test_instance_access},
-	{"UI Data Access",      _test_data_access},
-	{"UI Mixed DSP/UI",     _test_mixed},
-	//{"UI Binary",           _test_binary}, FIXME lilv does not support lv2:binary for UIs, yet
-	{"UI SOName",           _test_resident},
-	{"UI Extension Data",   _test_extension_data},
-	{"UI Idle Interface",   _test_idle_interface},
-	{"UI Show Interface",   _test_show_interface},
-	{"UI Resize Interface", _test_resize_interface},
-	{"UI Toolkit",          _test_toolkit},
+	{"UI Instance Access",  _test_instance_access,  COST_META,    NEEDS_NONE},
+	{"UI Data Access",      _test_data_access,      COST_META,    NEEDS_NONE},
+	{"UI Mixed DSP/UI",     _test_mixed,            COST_META,    NEEDS_NONE},
+	//{"UI Binary",           _test_binary,           COST_META,    NEEDS_NONE}, FIXME lilv does not support lv2:binary for UIs, yet
+	{"UI SOName",           _test_resident,         COST_META,    NEEDS_NONE},
+	{"UI Extension Data",   _test_extension_data,   COST_RUNTIME, NEEDS_UI},
+	{"UI Idle Interface",   _test_idle_interface,   COST_RUNTIME, NEEDS_UI},
+	{"UI Show Interface",   _test_show_interface,   COST_RUNTIME, NEEDS_UI},
+	{"UI Resize Interface", _test_resize_interface, COST_RUNTIME, NEEDS_UI},
+	{"UI Toolkit",          _test_toolkit,          COST_META,    NEEDS_NONE},
 #ifdef ENABLE_ONLINE_TESTS
-	{"UI URL",              _test_ui_url},
+	{"UI URL",              _test_ui_url,           COST_NETWORK, NEEDS_NONE},
 #endif
 };
 
@@ -558,9 +554,24 @@ test_ui(app_t *app)
 	const char *ui_binary_uri = lilv_node_as_uri(ui_binary_node);
 	char *ui_binary_path = lilv_file_uri_parse(ui_binary_uri, NULL);
 
+	needs_t needs = lv2lint_tests_needs(app, app->ui_uri, tests, tests_n);
+#ifdef ENABLE_X11_TESTS
+	if(lilv_ui_is_a(app->ui, NODE(app, UI__X11UI)))
+	{
+		needs |= test_x11_needs(app);
+	}
+#endif
+
+	if(!(needs & NEEDS_UI)) // do not load any UI code if no selected test calls into it
+	{
+		goto skip_load;
+	}
+
 	dlerror();
 
+	const uint64_t t0 = lv2lint_now();
 	lib = dlopen(ui_binary_path, RTLD_NOW);
+	lv2lint_timing(app, TIMING_PHASE, "UI Load", t0);
 	if(!lib)
 	{
 		fprintf(stderr, "Unable to open UI library %s (%s)\n", ui_binary_path, dlerror());
@@ -615,24 +626,11 @@ test_ui(app_t *app)
 		? app->ui_descriptor->extension_data(LV2_UI__resize)
 		: NULL;
 
-	for(unsigned i=0; i<tests_n; i++)
-	{
-		const test_t *test = &tests[i];
-		res_t *res = &rets[i];
-
-		res->is_whitelisted = lv2lint_test_is_whitelisted(app, app->ui_uri, test);
-		res->urn = NULL;
-		app->urn = &res->urn;
-		res->ret = test->cb(app);
-		const lint_t lnt = lv2lint_extract(app, res->ret);
-		if(lnt & app->show)
-		{
-			msg = true;
-		}
-	}
+skip_load:
+	msg = lv2lint_run_tests(app, app->ui_uri, tests, tests_n, rets);
 
 #ifdef ENABLE_X11_TESTS
-	if(lilv_ui_is_a(app->ui, NODE(app, UI__X11UI)))
+	if(!app->failed_fast && lilv_ui_is_a(app->ui, NODE(app, UI__X11UI)))
 	{
 		test_x11(app, &flag);
 	}
@@ -660,13 +658,6 @@ test_ui(app_t *app)
 		}
 	}
 
-	for(unsigned i=0; i<tests_n; i++)
-	{
-		res_t *res = &rets[i];
-
-		free(res->urn);
-	}
-
 jump:
 	if(ui_binary_path)
 	{
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+
+#include <lv2lint.h>
+
+#define DEBOUNCE_MS 250
+#define REWATCH_MS 500
+
+#define WATCH_MASK (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE \
+	| IN_DELETE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF)
+
+static bool
+_has_suffix(const char *name, const char *suffix)
+{
+	const size_t name_len = strlen(name);
+	const size_t suffix_len = strlen(suffix);
+
+	return (name_len >= suffix_len)
+		&& !strcmp(name + name_len - suffix_len, suffix);
+}
+
+// only Turtle files and binaries are relevant, e.g. ignore editor swap files
+static bool
+_is_relevant(const char *name)
+{
+	return _has_suffix(name, ".ttl")
+		|| _has_suffix(name, ".so")
+		|| _has_suffix(name, ".dylib")
+		|| _has_suffix(name, ".dll");
+}
+
+static void
+_rewatch(app_t *app, int fd, int *wds, bool *dirty)
+{
+	for(unsigned i = 0; i < app->n_include_dirs; i++)
+	{
+		if(wds[i] != -1)
+		{
+			continue;
+		}
+
+		wds[i] = inotify_add_watch(fd, app->include_dirs[i], WATCH_MASK);
+
+		if(wds[i] != -1) // bundle has been (re)created in the meantime
+		{
+			dirty[i] = true;
+		}
+	}
+}
+
+static bool
+_missing_watches(app_t *app, const int *wds)
+{
+	for(unsigned i = 0; i < app->n_include_dirs; i++)
+	{
+		if(wds[i] == -1)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// returns whether any relevant event was read
+static bool
+_drain(app_t *app, int fd, int *wds, bool *dirty)
+{
+	char buf [4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	bool relevant = false;
+	ssize_t len;
+
+	while( (len = read(fd, buf, sizeof(buf))) > 0)
+	{
+		for(const char *ptr = buf; ptr < buf + len; )
+		{
+			const struct inotify_event *ev = (const struct inotify_event *)ptr;
+
+			for(unsigned i = 0; i < app->n_include_dirs; i++)
+			{
+				if(wds[i] != ev->wd)
+				{
+					continue;
+				}
+
+				if(ev->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF))
+				{
+					if(ev->mask & IN_IGNORED)
+					{
+						wds[i] = -1;
+					}
+
+					dirty[i] = true;
+					relevant = true;
+				}
+				else if(ev->len && _is_relevant(ev->name))
+				{
+					dirty[i] = true;
+					relevant = true;
+				}
+			}
+
+			ptr += sizeof(struct inotify_event) + ev->len;
+		}
+	}
+
+	return relevant;
+}
+
+static void
+_reload(app_t *app, const LilvNode *bundle_node)
+{
+	const LilvPlugins *plugins = lilv_world_get_all_plugins(app->world);
+
+	// plugin data is loaded separately from the bundle and must be dropped too
+	LILV_FOREACH(plugins, itr, plugins)
+	{
+		const LilvPlugin *plugin = lilv_plugins_get(plugins, itr);
+
+		if(lilv_node_equals(lilv_plugin_get_bundle_uri(plugin), bundle_node))
+		{
+			lilv_world_unload_resource(app->world, lilv_plugin_get_uri(plugin));
+		}
+	}
+
+	lilv_world_unload_bundle(app->world, bundle_node);
+	lilv_world_load_bundle(app->world, bundle_node);
+	lilv_world_load_resource(app->world, bundle_node);
+}
+
+static void
+_relint(app_t *app, LilvNode **bundle_nodes, const bool *dirty,
+	char **args, unsigned n_args)
+{
+	const LilvPlugins *plugins = lilv_world_get_all_plugins(app->world);
+	int ret = 0;
+	unsigned n_uris = 0;
+	const char **uris = plugins
+		? lv2lint_collect_uris(app, plugins, args, n_args, &n_uris)
+		: NULL;
+
+	if(!uris)
+	{
+		return;
+	}
+
+	lv2lint_format_begin(app);
+
+	for(unsigned u = 0; u < n_uris; u++)
+	{
+		LilvNode *uri_node = lilv_new_uri(app->world, uris[u]);
+		const LilvPlugin *plugin = uri_node
+			? lilv_plugins_get_by_uri(plugins, uri_node)
+			: NULL;
+		bool changed = false;
+
+		for(unsigned i = 0; plugin && !changed && (i < app->n_include_dirs); i++)
+		{
+			changed = dirty[i] && bundle_nodes[i]
+				&& lilv_node_equals(lilv_plugin_get_bundle_uri(plugin), bundle_nodes[i]);
+		}
+
+		if(uri_node)
+		{
+			lilv_node_free(uri_node);
+		}
+
+		if(changed)
+		{
+			ret += lv2lint_run_uri(app, plugins, uris[u]);
+		}
+	}
+
+	lv2lint_format_end(app, ret);
+	free(uris);
+}
+
+int
+lv2lint_watch(app_t *app, char **args, unsigned n_args)
+{
+	const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	int *wds = calloc(app->n_include_dirs + 1, sizeof(int));
+	bool *dirty = calloc(app->n_include_dirs + 1, sizeof(bool));
+	LilvNode **bundle_nodes = calloc(app->n_include_dirs + 1, sizeof(LilvNode *));
+
+	if( (fd == -1) || !wds || !dirty || !bundle_nodes)
+	{
+		if(fd != -1)
+		{
+			close(fd);
+		}
+
+		free(wds);
+		free(dirty);
+		free(bundle_nodes);
+
+		return -1;
+	}
+
+	for(unsigned i = 0; i < app->n_include_dirs; i++)
+	{
+		wds[i] = inotify_add_watch(fd, app->include_dirs[i], WATCH_MASK);
+		bundle_nodes[i] = lilv_new_file_uri(app->world, NULL, app->include_dirs[i]);
+	}
+
+	fflush(app->out);
+
+	while(true)
+	{
+		struct pollfd pfd = {
+			.fd = fd,
+			.events = POLLIN
+		};
+		const int timeout = _missing_watches(app, wds)
+			? REWATCH_MS
+			: -1;
+
+		const int n = poll(&pfd, 1, timeout);
+
+		if( (n == -1) && (errno != EINTR) )
+		{
+			break;
+		}
+
+		_rewatch(app, fd, wds, dirty);
+
+		if( (n <= 0) || !_drain(app, fd, wds, dirty) )
+		{
+			bool any = false;
+
+			for(unsigned i = 0; i < app->n_include_dirs; i++)
+			{
+				any = any || dirty[i];
+			}
+
+			if(!any)
+			{
+				continue;
+			}
+		}
+
+		// debounce, wait until writes to the bundle have settled
+		while(poll(&pfd, 1, DEBOUNCE_MS) > 0)
+		{
+			_drain(app, fd, wds, dirty);
+		}
+
+		_rewatch(app, fd, wds, dirty);
+
+		for(unsigned i = 0; i < app->n_include_dirs; i++)
+		{
+			if(dirty[i] && bundle_nodes[i])
+			{
+				_reload(app, bundle_nodes[i]);
+			}
+		}
+
+		_relint(app, bundle_nodes, dirty, args, n_args);
+
+		for(unsigned i = 0; i < app->n_include_dirs; i++)
+		{
+			dirty[i] = false;
+		}
+	}
+
+	for(unsigned i = 0; i < app->n_include_dirs; i++)
+	{
+		if(bundle_nodes[i])
+		{
+			lilv_node_free(bundle_nodes[i]);
+		}
+	}
+
+	close(fd);
+	free(wds);
+	free(dirty);
+	free(bundle_nodes);
+
+	return -1;
+}
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2016-2021 Hanspeter Portner (dev@open-music-kontrollers.ch)
+ *
+ * This is free software: you can redistribute it and/or modify
+ * it under the terms of the Artistic License 2.0 as published by
+ * The Perl Foundation.
+ *
+ * This source is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Artistic License 2.0 for more details.
+ *
+ * You should have received a copy of the Artistic License 2.0
+ * along the source as a COPYING file. If not, obtain it from
+ * http://www.perlfoundation.org/artistic_license_2_0.
+ */
+
+#include <ctype.h>
+
+#if defined(HAS_FNMATCH)
+#	include <fnmatch.h>
+#endif
+
+#include <lv2lint.h>
+
+#define FOLD_BUF_SIZE 512
+
+typedef enum _pattern_t {
+	PATTERN_EXACT,
+	PATTERN_PREFIX,
+	PATTERN_GLOB
+} pattern_t;
+
+bool
+lv2lint_pattern_match(const char *pattern, const char *str)
+{
+	if(pattern == NULL)
+	{
+		return true;
+	}
+
+#if defined(HAS_FNMATCH)
+	if(fnmatch(pattern, str, FNM_CASEFOLD) == 0)
+#else
+	if(strcasecmp(pattern, str) == 0)
+#endif
+	{
+		return true;
+	}
+
+	return false;
+}
+
+static pattern_t
+_pattern_type(const char *pattern, size_t *prefix_len)
+{
+#if defined(HAS_FNMATCH)
+	const size_t len = strlen(pattern);
+	const size_t meta = strcspn(pattern, "*?[\\");
+
+	if(meta == len)
+	{
+		return PATTERN_EXACT;
+	}
+
+	if( (meta == len - 1) && (pattern[meta] == '*') )
+	{
+		*prefix_len = meta;
+
+		return PATTERN_PREFIX;
+	}
+
+	return PATTERN_GLOB;
+#else
+	(void)pattern;
+	(void)prefix_len;
+
+	return PATTERN_EXACT; // no wildcards without fnmatch
+#endif
+}
+
+static char *
+_fold(const char *str, char *buf, size_t size)
+{
+	const size_t len = strlen(str);
+
+	if(len >= size)
+	{
+		buf = malloc(len + 1);
+
+		if(!buf)
+		{
+			return NULL;
+		}
+	}
+
+	for(size_t i = 0; i <= len; i++)
+	{
+		buf[i] = tolower((unsigned char)str[i]);
+	}
+
+	return buf;
+}
+
+static trie_node_t *
+_trie_child(trie_node_t **child, char c)
+{
+	for( ; *child; child = &(*child)->sibling)
+	{
+		if((*child)->c == c)
+		{
+			return *child;
+		}
+	}
+
+	*child = calloc(1, sizeof(trie_node_t));
+
+	if(*child)
+	{
+		(*child)->c = c;
+	}
+
+	return *child;
+}
+
+static int
+_trie_insert(trie_node_t *root, const white_t *white, size_t prefix_len)
+{
+	trie_node_t *node = root;
+
+	for(size_t i = 0; i < prefix_len; i++)
+	{
+		node = _trie_child(&node->child, tolower((unsigned char)white->pattern[i]));
+
+		if(!node)
+		{
+			return -1;
+		}
+	}
+
+	const white_t **whites = realloc(node->whites,
+		(node->n_whites + 1) * sizeof(const white_t *));
+
+	if(!whites)
+	{
+		return -1;
+	}
+
+	whites[node->n_whites++] = white;
+	node->whites = whites;
+
+	return 0;
+}
+
+static void
+_trie_free(trie_node_t *node)
+{
+	while(node)
+	{
+		trie_node_t *sibling = node->sibling;
+
+		_trie_free(node->child);
+		free(node->whites);
+		free(node);
+
+		node = sibling;
+	}
+}
+
+static bool
+_whites_match(const white_t *const *whites, uint32_t n_whites, const char *uri)
+{
+	for(uint32_t i = 0; i < n_whites; i++)
+	{
+		if(lv2lint_pattern_match(whites[i]->uri, uri))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int
+lv2lint_matcher_init(matcher_t *matcher, const white_t *white)
+{
+	uint32_t n_whites = 0;
+
+	memset(matcher, 0x0, sizeof(matcher_t));
+
+	for(const white_t *w = white; w; w = w->next)
+	{
+		n_whites += 1;
+	}
+
+	if(!n_whites)
+	{
+		return 0;
+	}
+
+	matcher->exact_keys = calloc(n_whites, sizeof(char *));
+	matcher->exact_whites = calloc(n_whites, sizeof(const white_t *));
+	matcher->exact_next = calloc(n_whites, sizeof(uint32_t));
+	matcher->globs = calloc(n_whites, sizeof(const white_t *));
+	matcher->prefixes = calloc(1, sizeof(trie_node_t));
+
+	if(  !matcher->exact_keys || !matcher->exact_whites || !matcher->exact_next
+		|| !matcher->globs || !matcher->prefixes
+		|| lv2lint_hashset_init(&matcher->exact, n_whites) )
+	{
+		lv2lint_matcher_deinit(matcher);
+		return -1;
+	}
+
+	for(const white_t *w = white; w; w = w->next)
+	{
+		size_t prefix_len = 0;
+
+		switch(_pattern_type(w->pattern, &prefix_len))
+		{
+			case PATTERN_EXACT:
+			{
+				char *key = _fold(w->pattern, NULL, 0);
+
+				if(!key)
+				{
+					lv2lint_matcher_deinit(matcher);
+					return -1;
+				}
+
+				const uint32_t idx = matcher->n_exact++;
+				bool is_new;
+
+				matcher->exact_keys[idx] = key;
+				matcher->exact_whites[idx] = w;
+				matcher->exact_next[idx] = idx;
+
+				hash_entry_t *entry = lv2lint_hashset_insert(&matcher->exact, key, idx,
+					&is_new);
+
+				if(entry && !is_new)
+				{
+					matcher->exact_next[idx] = matcher->exact_next[entry->idx];
+					matcher->exact_next[entry->idx] = idx;
+				}
+			} break;
+			case PATTERN_PREFIX:
+			{
+				if(_trie_insert(matcher->prefixes, w, prefix_len))
+				{
+					lv2lint_matcher_deinit(matcher);
+					return -1;
+				}
+			} break;
+			case PATTERN_GLOB:
+			{
+				matcher->globs[matcher->n_globs++] = w;
+			} break;
+		}
+	}
+
+	return 0;
+}
+
+void
+lv2lint_matcher_deinit(matcher_t *matcher)
+{
+	for(uint32_t i = 0; i < matcher->n_exact; i++)
+	{
+		free(matcher->exact_keys[i]);
+	}
+
+	lv2lint_hashset_deinit(&matcher->exact);
+	free(matcher->exact_keys);
+	free(matcher->exact_whites);
+	free(matcher->exact_next);
+	free(matcher->globs);
+	_trie_free(matcher->prefixes);
+
+	memset(matcher, 0x0, sizeof(matcher_t));
+}
+
+bool
+lv2lint_matcher_match(const matcher_t *matcher, const char *uri, const char *str)
+{
+	char buf [FOLD_BUF_SIZE];
+	char *folded = _fold(str, buf, sizeof(buf));
+	bool match = false;
+
+	if(!folded)
+	{
+		return false;
+	}
+
+	// exact patterns, O(1)
+	const hash_entry_t *entry = lv2lint_hashset_lookup(&matcher->exact, folded);
+
+	if(entry)
+	{
+		uint32_t idx = entry->idx;
+
+		do
+		{
+			match = lv2lint_pattern_match(matcher->exact_whites[idx]->uri, uri);
+			idx = matcher->exact_next[idx];
+		} while(!match && (idx != entry->idx) );
+	}
+
+	// literal prefix patterns, O(strlen)
+	const char *c = folded;
+
+	for(const trie_node_t *node = matcher->prefixes; !match && node; c++)
+	{
+		match = _whites_match(node->whites, node->n_whites, uri);
+
+		const trie_node_t *child = *c ? node->child : NULL;
+
+		while(child && (child->c != *c))
+		{
+			child = child->sibling;
+		}
+
+		node = child;
+	}
+
+	// true globs
+	for(uint32_t i = 0; !match && (i < matcher->n_globs); i++)
+	{
+		const white_t *white = matcher->globs[i];
+
+		match = lv2lint_pattern_match(white->uri, uri)
+			&& lv2lint_pattern_match(white->pattern, str);
+	}
+
+	if(folded != buf) // heap allocated for long strings
+	{
+		free(folded);
+	}
+
+	return match;
+}
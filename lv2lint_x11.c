@@ -201,13 +201,19 @@ _test_ui_hints(app_t *app)
 }
 
 static const test_t tests [] = {
-	{"UI Instantiation",    _test_ui_instantiation},
-	{"UI Widget",           _test_ui_widget},
-	{"UI Hints",            _test_ui_hints},
+	{"UI Instantiation",    _test_ui_instantiation, COST_X11, NEEDS_UI | WANTS_INSTANCE},
+	{"UI Widget",           _test_ui_widget,        COST_X11, NEEDS_UI | WANTS_INSTANCE},
+	{"UI Hints",            _test_ui_hints,         COST_X11, NEEDS_UI | WANTS_INSTANCE},
 };
 
 static const unsigned tests_n = sizeof(tests) / sizeof(test_t);
 
+needs_t
+test_x11_needs(app_t *app)
+{
+	return lv2lint_tests_needs(app, app->ui_uri, tests, tests_n);
+}
+
 void
 test_x11(app_t *app, bool *flag)
 {
@@ -217,6 +223,15 @@ test_x11(app_t *app, bool *flag)
 		return;
 	}
 
+	const needs_t needs = test_x11_needs(app);
+	if(!(needs & NEEDS_UI)) // no test selected
+	{
+		return;
+	}
+
+	// instance-access and data-access features are filled in below
+	lv2lint_acquire(app, needs);
+
 	bool msg = false;
 	res_t *rets = alloca(tests_n * sizeof(res_t));
 	if(!rets)
@@ -476,9 +491,11 @@ test_x11(app_t *app, bool *flag)
 	{
 		if(app->ui_descriptor && app->ui_descriptor->instantiate)
 		{
+			const uint64_t t0 = lv2lint_now();
 			app->ui_instance = app->ui_descriptor->instantiate(app->ui_descriptor,
 				app->plugin_uri, ui_plugin_bundle_path, _write_function, app,
 				(void *)&app->ui_widget, features);
+			lv2lint_timing(app, TIMING_PHASE, "UI Instantiation", t0);
 		}
 
 		lilv_free(ui_plugin_bundle_path);
@@ -491,21 +508,7 @@ test_x11(app_t *app, bool *flag)
 	}
 #endif
 
-	for(unsigned i=0; i<tests_n; i++)
-	{
-		const test_t *test = &tests[i];
-		res_t *res = &rets[i];
-
-		res->is_whitelisted = lv2lint_test_is_whitelisted(app, app->ui_uri, test);
-		res->urn = NULL;
-		app->urn = &res->urn;
-		res->ret = test->cb(app);
-		const lint_t lnt = lv2lint_extract(app, res->ret);
-		if(lnt & app->show)
-		{
-			msg = true;
-		}
-	}
+	msg = lv2lint_run_tests(app, app->ui_uri, tests, tests_n, rets);
 
 	if(app->ui_instance)
 	{
@@ -540,13 +543,6 @@ test_x11(app_t *app, bool *flag)
 		}
 	}
 
-	for(unsigned i=0; i<tests_n; i++)
-	{
-		res_t *res = &rets[i];
-
-		free(res->urn);
-	}
-
 jump:
 	if(display)
 	{